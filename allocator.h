@@ -23,25 +23,173 @@
 #ifndef GUARD_NOE_STD_allocator_H
 #define GUARD_NOE_STD_allocator_H
 
+#include <cstddef>
 #include <cstdint>
+#include <cstdlib>
+#include <cstring>
 #include <limits>
+#include <memory>
 #include <new>
+#include <type_traits>
 #include <utility>
 #include "macro.h"
 
+#if defined(__GLIBC__)
+#include <malloc.h>
+#elif defined(__APPLE__)
+#include <malloc/malloc.h>
+#elif defined(_WIN32)
+#include <malloc.h>
+#endif // defined(__GLIBC__)
+
 namespace noe_std
 {
 namespace detail
 {
-    template<class T>
+    /// Largest element count whose block, rounded up to Alignment, still fits a size_t
+    template<class T, std::size_t Alignment = 1>
     struct allocator_max_size
     {
-        enum : std::size_t { value = std::numeric_limits<std::size_t>::max() / sizeof(T) };
+        enum : std::size_t { value = (std::numeric_limits<std::size_t>::max() - (Alignment - 1)) / sizeof(T) };
+    };
+
+    /// Bytes actually reserved by malloc for p, at least the requested bytes
+    inline std::size_t malloc_usable_bytes(void* p, std::size_t requested) noe_std_no_except
+    {
+#if defined(__GLIBC__)
+        (void)requested;
+        return ::malloc_usable_size(p);
+#elif defined(__APPLE__)
+        (void)requested;
+        return ::malloc_size(p);
+#else
+        (void)p;
+        return requested;
+#endif // defined(__GLIBC__)
+    }
+    /// Alignments malloc already guarantees
+    inline bool is_fundamental_alignment(std::size_t alignment) noe_std_no_except
+    {
+        return alignment <= std::alignment_of<std::max_align_t>::value;
+    }
+
+    /// Size of a block holding bytes, over-aligned blocks are rounded up to a multiple of the alignment
+    inline std::size_t aligned_block_bytes(std::size_t bytes, std::size_t alignment) noe_std_no_except
+    {
+        if(is_fundamental_alignment(alignment))
+            return bytes;
+        return (bytes + alignment - 1) & ~(alignment - 1);
+    }
+
+    /// Usable bytes of an aligned block, over-aligned blocks only count whole alignment units
+    /// so the slack malloc hands out never spills onto a line shared with the next block
+    inline std::size_t aligned_usable_bytes(void* p, std::size_t requested, std::size_t alignment) noe_std_no_except
+    {
+        std::size_t usable = malloc_usable_bytes(p, requested);
+        if(is_fundamental_alignment(alignment))
+            return usable;
+        return usable & ~(alignment - 1);
+    }
+
+    /// malloc for fundamental alignments, posix_memalign (_aligned_malloc on Windows) otherwise
+    inline void* aligned_malloc(std::size_t bytes, std::size_t alignment) noe_std_no_except
+    {
+        if(is_fundamental_alignment(alignment))
+            return std::malloc(bytes);
+#if defined(_WIN32)
+        return ::_aligned_malloc(bytes, alignment);
+#else
+        void* p = 0;
+        return ::posix_memalign(&p, alignment, bytes) == 0 ? p : 0;
+#endif // defined(_WIN32)
+    }
+
+    inline void aligned_free(void* p, std::size_t alignment) noe_std_no_except
+    {
+#if defined(_WIN32)
+        if(!is_fundamental_alignment(alignment)) {
+            ::_aligned_free(p);
+            return;
+        }
+#else
+        (void)alignment;
+#endif // defined(_WIN32)
+        std::free(p);
+    }
+
+    /// realloc keeping the alignment, 0 on failure with p left untouched
+    inline void* aligned_realloc(void* p, std::size_t old_bytes, std::size_t new_bytes, std::size_t alignment) noe_std_no_except
+    {
+        if(is_fundamental_alignment(alignment))
+            return std::realloc(p, new_bytes);
+#if defined(_WIN32)
+        (void)old_bytes;
+        return ::_aligned_realloc(p, new_bytes, alignment);
+#else
+        // realloc may hand back a block with only the fundamental alignment, so move by hand
+        if(aligned_usable_bytes(p, old_bytes, alignment) >= new_bytes)
+            return p;
+        void* result = aligned_malloc(new_bytes, alignment);
+        if(result) {
+            std::memcpy(result, p, old_bytes < new_bytes ? old_bytes : new_bytes);
+            std::free(p);
+        }
+        return result;
+#endif // defined(_WIN32)
+    }
+#if __cplusplus >= 201103L
+    /// Detects the optional allocator extensions used by vector:
+    ///  - allocation_result<pointer> allocate_at_least(n): allocates at least n elements and reports how many fit
+    ///  - bool try_expand(p, old_n, new_n): grows the block at p in place
+    ///  - bool shrink_in_place(p, old_n, new_n): gives back the tail of the block at p without moving it
+    ///  - pointer reallocate(p, old_n, new_n): resizes the block, possibly moving its bytes (0 on failure,
+    ///    p stays valid), only used for trivially relocatable elements
+    template<class AllocatorT>
+    struct allocator_extensions
+    {
+    private:
+        typedef typename std::allocator_traits<AllocatorT>::pointer     pointer;
+        typedef typename std::allocator_traits<AllocatorT>::size_type   size_type;
+
+        template<class A> static auto test_allocate_at_least(int) -> decltype(std::declval<A&>().allocate_at_least(size_type()), std::true_type());
+        template<class A> static std::false_type test_allocate_at_least(...);
+        template<class A> static auto test_try_expand(int) -> decltype(std::declval<A&>().try_expand(pointer(), size_type(), size_type()), std::true_type());
+        template<class A> static std::false_type test_try_expand(...);
+        template<class A> static auto test_shrink_in_place(int) -> decltype(std::declval<A&>().shrink_in_place(pointer(), size_type(), size_type()), std::true_type());
+        template<class A> static std::false_type test_shrink_in_place(...);
+        template<class A> static auto test_reallocate(int) -> decltype(std::declval<A&>().reallocate(pointer(), size_type(), size_type()), std::true_type());
+        template<class A> static std::false_type test_reallocate(...);
+
+    public:
+        typedef decltype(test_allocate_at_least<AllocatorT>(0))  has_allocate_at_least;
+        typedef decltype(test_try_expand<AllocatorT>(0))         has_try_expand;
+        typedef decltype(test_shrink_in_place<AllocatorT>(0))    has_shrink_in_place;
+        typedef decltype(test_reallocate<AllocatorT>(0))         has_reallocate;
     };
+#endif // __cplusplus >= 201103L
 }
-    template<class T>
-    class allocator
+    /// Result of allocate_at_least, count is the number of elements that fit at ptr
+    template<class Pointer, class SizeType = std::size_t>
+    struct allocation_result
     {
+        Pointer     ptr;
+        SizeType    count;
+    };
+
+    /// Alignment that keeps adjacent allocations off each other's cache lines
+    enum : std::size_t { cache_line_size = 64 };
+
+    /// malloc based allocator returning storage aligned to at least Alignment bytes (and alignof(T)).
+    /// Besides allocate / deallocate it offers allocate_at_least, try_expand and reallocate
+    /// (see detail::allocator_extensions). shrink_in_place is left out since realloc can not
+    /// promise to keep a shrunk block in place.
+    /// Over-aligned blocks are rounded up to a multiple of the alignment, so with
+    /// Alignment = cache_line_size two containers never share a cache line.
+    template<class T, std::size_t Alignment>
+    class aligned_allocator
+    {
+        static_assert(Alignment && !(Alignment & (Alignment - 1)), "aligned_allocator needs a power of two alignment");
+
     public:
         typedef T                   value_type;
         typedef value_type*         pointer;
@@ -51,17 +199,22 @@ namespace detail
         typedef std::size_t       size_type;
         typedef std::ptrdiff_t    difference_type;
 
+        enum : std::size_t { alignment = Alignment > std::alignment_of<T>::value ? Alignment : std::alignment_of<T>::value };
+
         template<class U>
         struct rebind
         {
-            typedef allocator<U> other;
+            typedef aligned_allocator<U, Alignment> other;
         };
 
-        allocator() noe_std_no_except {}
-        ~allocator() noe_std_no_except {}
+        aligned_allocator() noe_std_no_except {}
+        ~aligned_allocator() noe_std_no_except {}
 
         pointer allocate(size_type n) noe_std_no_except;
         void deallocate(pointer p, size_type n) noe_std_no_except;
+        allocation_result<pointer, size_type> allocate_at_least(size_type n) noe_std_no_except;
+        bool try_expand(pointer p, size_type old_n, size_type new_n) noe_std_no_except;
+        pointer reallocate(pointer p, size_type old_n, size_type new_n) noe_std_no_except;
 #if __cplusplus >= 201103L
         constexpr size_type max_size() const noexcept;
         template<class... Args> void construct(pointer p, Args&&... args);
@@ -70,47 +223,94 @@ namespace detail
         static void construct(pointer p, const_reference t);
 #endif // __cplusplus >= 201103L
         void destroy(pointer p);
+
+    private:
+        static std::size_t block_bytes(size_type n) noe_std_no_except { return detail::aligned_block_bytes(n * sizeof(T), alignment); }
     };
 
+    /// The default allocator, aligned_allocator with the natural alignment of T,
+    /// so over-aligned T still gets correctly aligned storage
     template<class T>
-    typename allocator<T>::pointer allocator<T>::allocate(size_type n) noe_std_no_except
+    class allocator : public aligned_allocator<T, std::alignment_of<T>::value>
     {
-        return static_cast<pointer>(::operator new(n * sizeof(T), std::nothrow));
+    public:
+        template<class U>
+        struct rebind
+        {
+            typedef allocator<U> other;
+        };
+
+        allocator() noe_std_no_except {}
+        ~allocator() noe_std_no_except {}
+    };
+
+    template<class T, std::size_t Alignment>
+    typename aligned_allocator<T, Alignment>::pointer aligned_allocator<T, Alignment>::allocate(size_type n) noe_std_no_except
+    {
+        if(n > detail::allocator_max_size<T, alignment>::value)
+            return 0;
+        return static_cast<pointer>(detail::aligned_malloc(block_bytes(n), alignment));
     }
 
-    template<class T>
-    void allocator<T>::deallocate(pointer p, size_type) noe_std_no_except
+    template<class T, std::size_t Alignment>
+    void aligned_allocator<T, Alignment>::deallocate(pointer p, size_type) noe_std_no_except
+    {
+        detail::aligned_free(p, alignment);
+    }
+
+    template<class T, std::size_t Alignment>
+    allocation_result<typename aligned_allocator<T, Alignment>::pointer, typename aligned_allocator<T, Alignment>::size_type> aligned_allocator<T, Alignment>::allocate_at_least(size_type n) noe_std_no_except
+    {
+        allocation_result<pointer, size_type> result;
+        result.ptr = allocate(n);
+        result.count = result.ptr ? detail::aligned_usable_bytes(result.ptr, block_bytes(n), alignment) / sizeof(T) : 0;
+        return result;
+    }
+
+    template<class T, std::size_t Alignment>
+    bool aligned_allocator<T, Alignment>::try_expand(pointer p, size_type, size_type new_n) noe_std_no_except
     {
-        ::operator delete(p);
+        // malloc rounds up to its size classes, the block may already hold new_n elements
+        if(new_n > detail::allocator_max_size<T, alignment>::value)
+            return false;
+        return detail::aligned_usable_bytes(p, 0, alignment) >= new_n * sizeof(T);
+    }
+
+    template<class T, std::size_t Alignment>
+    typename aligned_allocator<T, Alignment>::pointer aligned_allocator<T, Alignment>::reallocate(pointer p, size_type old_n, size_type new_n) noe_std_no_except
+    {
+        if(new_n == 0 || new_n > detail::allocator_max_size<T, alignment>::value)
+            return 0;
+        return static_cast<pointer>(detail::aligned_realloc(p, old_n * sizeof(T), block_bytes(new_n), alignment));
     }
 #if __cplusplus >= 201103L
-    template<class T>
-    constexpr typename allocator<T>::size_type allocator<T>::max_size() const noexcept
+    template<class T, std::size_t Alignment>
+    constexpr typename aligned_allocator<T, Alignment>::size_type aligned_allocator<T, Alignment>::max_size() const noexcept
     {
-        return detail::allocator_max_size<T>::value;
+        return detail::allocator_max_size<T, alignment>::value;
     }
 
-    template<class T>
+    template<class T, std::size_t Alignment>
     template<class... Args>
-    void allocator<T>::construct(pointer p, Args&&... args)
+    void aligned_allocator<T, Alignment>::construct(pointer p, Args&&... args)
     {
         new(p) T(std::forward<Args>(args)...);
     }
 #else
-    template<class T>
-    typename allocator<T>::size_type allocator<T>::max_size() const
+    template<class T, std::size_t Alignment>
+    typename aligned_allocator<T, Alignment>::size_type aligned_allocator<T, Alignment>::max_size() const
     {
-        return detail::allocator_max_size<T>::value;
+        return detail::allocator_max_size<T, alignment>::value;
     }
 
-    template<class T>
-    void allocator<T>::construct(pointer p, const_reference t)
+    template<class T, std::size_t Alignment>
+    void aligned_allocator<T, Alignment>::construct(pointer p, const_reference t)
     {
         new(p) T(t);
     }
 #endif // __cplusplus >= 201103L
-    template<class T>
-    void allocator<T>::destroy(pointer p)
+    template<class T, std::size_t Alignment>
+    void aligned_allocator<T, Alignment>::destroy(pointer p)
     {
         p->~T();
     }
@@ -0,0 +1,323 @@
+/**
+ * NoException Standard Library Container Implementation
+ * by Marvin Manese 2017
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+#ifndef GUARD_NOE_STD_concurrent_vector_H
+#define GUARD_NOE_STD_concurrent_vector_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include "allocator.h"
+#include "macro.h"
+#include "detail/indexed_iterator.h"
+
+namespace noe_std
+{
+namespace detail
+{
+    inline std::size_t concurrent_vector_log2(std::size_t n) noe_std_no_except
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return sizeof(unsigned long long) * 8 - 1 - static_cast<std::size_t>(__builtin_clzll(n));
+#else
+        std::size_t result = 0;
+        while(n >>= 1)
+            ++result;
+        return result;
+#endif // defined(__GNUC__) || defined(__clang__)
+    }
+}
+    /// Append only vector safe to grow from many threads at once.
+    /// Elements live in a table of segments, segment k holding 2^(FirstSegmentBits + k) elements,
+    /// segments are never moved or freed while the vector lives, so references stay valid.
+    /// Appenders install the segments their slots need before claiming the slots with a compare and
+    /// swap on the reservation counter, then construct them in parallel; a missing segment is
+    /// installed with a compare and swap too (the loser frees its copy).
+    /// Every slot has a ready flag set once its element is constructed, and size() is a watermark
+    /// covering the longest prefix of ready slots, so readers may index and iterate [0, size())
+    /// while other threads append. No appender ever waits for another one: after marking its own
+    /// slots it moves the watermark over every ready slot it finds, so a descheduled appender
+    /// only holds back size(), never the other appenders.
+    /// If a segment can not be allocated the appender returns false without claiming any slot,
+    /// so a failed append leaves no gap and every successful one becomes part of size().
+    /// clear, swap and destruction must not race with other operations.
+    template<class T,
+             class AllocatorT = allocator<T>,
+             std::size_t FirstSegmentBits = 5>
+    class concurrent_vector
+    {
+        enum : std::size_t { first_segment_size = std::size_t(1) << FirstSegmentBits };
+        enum : std::size_t { segment_count = sizeof(std::size_t) * 8 - FirstSegmentBits };
+
+    public:
+        typedef T                   value_type;
+        typedef AllocatorT          allocator_type;
+        typedef std::size_t         size_type;
+        typedef std::ptrdiff_t      difference_type;
+        typedef value_type&         reference;
+        typedef const value_type&   const_reference;
+        typedef detail::indexed_iterator<const concurrent_vector, const_reference, const T*>  const_iterator;
+        typedef const_iterator      iterator;
+
+    private:
+        typedef std::atomic<unsigned char>                                                      flag_type;
+        typedef typename std::allocator_traits<AllocatorT>::template rebind_alloc<flag_type>   flag_allocator_t;
+
+    public:
+
+        concurrent_vector() noe_std_no_except;
+        ~concurrent_vector();
+
+        /// Valid for every index below a size() observed by this thread
+        reference operator[](size_type n) { return segment_of(n)[offset_of(n)]; }
+        const_reference operator[](size_type n) const { return segment_of(n)[offset_of(n)]; }
+
+        /// Iterates the elements published when begin / end is called
+        const_iterator begin() const { return const_iterator(this, 0); }
+        const_iterator cbegin() const { return const_iterator(this, 0); }
+        const_iterator end() const { return const_iterator(this, size()); }
+        const_iterator cend() const { return const_iterator(this, size()); }
+
+        bool empty() const noe_std_no_except { return (size() == 0); }
+        size_type size() const noe_std_no_except { return m_published.load(std::memory_order_acquire); }
+        size_type max_size() const noe_std_no_except { return std::numeric_limits<size_type>::max() - first_segment_size; }
+        /// Allocates the segments up to n elements ahead of time
+        bool reserve(size_type n);
+
+        bool push_back(const_reference v);
+        bool push_back(value_type&& v);
+        template<class... Args> bool emplace_back(Args&&... args);
+        /// Appends n copies of v as one contiguous range of indices
+        bool grow_by(size_type n, const_reference v = T());
+        void clear();
+        void swap(concurrent_vector& other) noe_std_no_except;
+
+    private:
+        concurrent_vector(const concurrent_vector&);
+        concurrent_vector& operator=(const concurrent_vector&);
+
+        static size_type segment_index(size_type n) noe_std_no_except { return detail::concurrent_vector_log2((n >> FirstSegmentBits) + 1); }
+        static size_type segment_begin(size_type k) noe_std_no_except { return first_segment_size * ((size_type(1) << k) - 1); }
+        static size_type segment_size(size_type k) noe_std_no_except { return first_segment_size << k; }
+        size_type offset_of(size_type n) const noe_std_no_except { return n - segment_begin(segment_index(n)); }
+        T* segment_of(size_type n) const noe_std_no_except { return m_segments[segment_index(n)].load(std::memory_order_acquire); }
+
+        bool reserve_slots(size_type n, size_type& first) noe_std_no_except;
+        bool ensure_segments(size_type first, size_type last) noe_std_no_except;
+        bool ready(size_type n) const noe_std_no_except;
+        void publish(size_type first, size_type last) noe_std_no_except;
+
+        std::atomic<T*>             m_segments[segment_count];
+        std::atomic<flag_type*>     m_flags[segment_count];    // one ready flag per slot of the segment
+        // reservation counter and watermark sit on their own cache lines
+        alignas(64) std::atomic<size_type>  m_reserved;
+        alignas(64) std::atomic<size_type>  m_published;
+    };
+
+    template<class T, class AllocatorT, std::size_t FirstSegmentBits>
+    concurrent_vector<T, AllocatorT, FirstSegmentBits>::concurrent_vector() noe_std_no_except
+        : m_reserved(0), m_published(0)
+    {
+        for(size_type k = 0; k < segment_count; ++k) {
+            m_segments[k].store(0, std::memory_order_relaxed);
+            m_flags[k].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    template<class T, class AllocatorT, std::size_t FirstSegmentBits>
+    concurrent_vector<T, AllocatorT, FirstSegmentBits>::~concurrent_vector()
+    {
+        clear();
+        allocator_type alloc;
+        flag_allocator_t flag_alloc;
+        for(size_type k = 0; k < segment_count; ++k) {
+            if(T* segment = m_segments[k].load(std::memory_order_relaxed))
+                alloc.deallocate(segment, segment_size(k));
+            if(flag_type* flags = m_flags[k].load(std::memory_order_relaxed))
+                flag_alloc.deallocate(flags, segment_size(k));
+        }
+    }
+
+    template<class T, class AllocatorT, std::size_t FirstSegmentBits>
+    bool concurrent_vector<T, AllocatorT, FirstSegmentBits>::reserve(size_type n)
+    {
+        return n == 0 || (n <= max_size() && ensure_segments(0, n));
+    }
+
+    template<class T, class AllocatorT, std::size_t FirstSegmentBits>
+    bool concurrent_vector<T, AllocatorT, FirstSegmentBits>::push_back(const_reference v)
+    {
+        return emplace_back(v);
+    }
+
+    template<class T, class AllocatorT, std::size_t FirstSegmentBits>
+    bool concurrent_vector<T, AllocatorT, FirstSegmentBits>::push_back(value_type&& v)
+    {
+        return emplace_back(std::move(v));
+    }
+
+    template<class T, class AllocatorT, std::size_t FirstSegmentBits>
+    template<class... Args>
+    bool concurrent_vector<T, AllocatorT, FirstSegmentBits>::emplace_back(Args&&... args)
+    {
+        size_type n;
+        if(!reserve_slots(1, n))
+            return false;
+        ::new(static_cast<void*>(&(*this)[n])) T(std::forward<Args>(args)...);
+        publish(n, n + 1);
+        return true;
+    }
+
+    template<class T, class AllocatorT, std::size_t FirstSegmentBits>
+    bool concurrent_vector<T, AllocatorT, FirstSegmentBits>::grow_by(size_type n, const_reference v)
+    {
+        if(n == 0)
+            return true;
+        if(n > max_size())
+            return false;
+        size_type first;
+        if(!reserve_slots(n, first))
+            return false;
+        for(size_type i = first; i != first + n; ++i)
+            ::new(static_cast<void*>(&(*this)[i])) T(v);
+        publish(first, first + n);
+        return true;
+    }
+
+    template<class T, class AllocatorT, std::size_t FirstSegmentBits>
+    void concurrent_vector<T, AllocatorT, FirstSegmentBits>::clear()
+    {
+        // segments are kept for the next appends
+        size_type reserved = m_reserved.load(std::memory_order_relaxed);
+        for(size_type k = 0; k < segment_count && segment_begin(k) < reserved; ++k) {
+            flag_type* flags = m_flags[k].load(std::memory_order_relaxed);
+            if(!flags)
+                continue;
+            size_type count = std::min(segment_size(k), reserved - segment_begin(k));
+            for(size_type i = 0; i != count; ++i) {
+                if(flags[i].load(std::memory_order_relaxed)) {
+                    m_segments[k].load(std::memory_order_relaxed)[i].~T();
+                    flags[i].store(0, std::memory_order_relaxed);
+                }
+            }
+        }
+        m_reserved.store(0, std::memory_order_relaxed);
+        m_published.store(0, std::memory_order_release);
+    }
+
+    template<class T, class AllocatorT, std::size_t FirstSegmentBits>
+    void concurrent_vector<T, AllocatorT, FirstSegmentBits>::swap(concurrent_vector& other) noe_std_no_except
+    {
+        for(size_type k = 0; k < segment_count; ++k) {
+            m_segments[k].store(other.m_segments[k].exchange(m_segments[k].load(std::memory_order_relaxed), std::memory_order_relaxed), std::memory_order_relaxed);
+            m_flags[k].store(other.m_flags[k].exchange(m_flags[k].load(std::memory_order_relaxed), std::memory_order_relaxed), std::memory_order_relaxed);
+        }
+        m_reserved.store(other.m_reserved.exchange(m_reserved.load(std::memory_order_relaxed), std::memory_order_relaxed), std::memory_order_relaxed);
+        m_published.store(other.m_published.exchange(m_published.load(std::memory_order_relaxed), std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+
+    template<class T, class AllocatorT, std::size_t FirstSegmentBits>
+    bool concurrent_vector<T, AllocatorT, FirstSegmentBits>::reserve_slots(size_type n, size_type& first) noe_std_no_except
+    {
+        // the segments come first, a slot is only claimed once it has storage (a claimed slot
+        // that is never constructed would stop the watermark for good)
+        first = m_reserved.load(std::memory_order_relaxed);
+        do {
+            if(first > max_size() - n || !ensure_segments(first, first + n))
+                return false;
+        } while(!m_reserved.compare_exchange_weak(first, first + n, std::memory_order_relaxed, std::memory_order_relaxed));
+        return true;
+    }
+
+    template<class T, class AllocatorT, std::size_t FirstSegmentBits>
+    bool concurrent_vector<T, AllocatorT, FirstSegmentBits>::ensure_segments(size_type first, size_type last) noe_std_no_except
+    {
+        if(last > max_size())
+            return false;
+        allocator_type alloc;
+        flag_allocator_t flag_alloc;
+        size_type k_first = segment_index(first), k_last = segment_index(last - 1);
+        for(size_type k = k_first; k <= k_last; ++k) {
+            if(m_segments[k].load(std::memory_order_acquire))
+                continue;
+            T* segment = alloc.allocate(segment_size(k));
+            if(!segment)
+                return false;
+            T* expected = 0;
+            if(!m_segments[k].compare_exchange_strong(expected, segment, std::memory_order_acq_rel, std::memory_order_acquire))
+                alloc.deallocate(segment, segment_size(k));
+        }
+        // the flags are written to when allocated, so they only follow once all the element
+        // segments are there (a huge failing grow_by must not touch memory for nothing)
+        for(size_type k = k_first; k <= k_last; ++k) {
+            if(m_flags[k].load(std::memory_order_acquire))
+                continue;
+            flag_type* flags = flag_alloc.allocate(segment_size(k));
+            if(!flags)
+                return false;
+            for(size_type i = 0; i != segment_size(k); ++i)
+                ::new(static_cast<void*>(flags + i)) flag_type(0);
+            flag_type* expected = 0;
+            if(!m_flags[k].compare_exchange_strong(expected, flags, std::memory_order_acq_rel, std::memory_order_acquire))
+                flag_alloc.deallocate(flags, segment_size(k));
+        }
+        return true;
+    }
+
+    template<class T, class AllocatorT, std::size_t FirstSegmentBits>
+    inline bool concurrent_vector<T, AllocatorT, FirstSegmentBits>::ready(size_type n) const noe_std_no_except
+    {
+        if(n >= max_size())
+            return false;
+        flag_type* flags = m_flags[segment_index(n)].load(std::memory_order_acquire);
+        return flags && flags[offset_of(n)].load(std::memory_order_seq_cst);
+    }
+
+    template<class T, class AllocatorT, std::size_t FirstSegmentBits>
+    void concurrent_vector<T, AllocatorT, FirstSegmentBits>::publish(size_type first, size_type last) noe_std_no_except
+    {
+        flag_type* flags = 0;
+        for(size_type i = first; i != last; ++i) {
+            if(i == first || offset_of(i) == 0)
+                flags = m_flags[segment_index(i)].load(std::memory_order_acquire);
+            flags[offset_of(i)].store(1, std::memory_order_seq_cst);
+        }
+        // help move the watermark, whichever appender marks its slots last sees all the earlier
+        // flags (the flag stores and loads are sequentially consistent), so none is left behind
+        size_type published = m_published.load(std::memory_order_seq_cst);
+        for(;;) {
+            size_type end = published;
+            while(ready(end))
+                ++end;
+            if(end == published || m_published.compare_exchange_weak(published, end, std::memory_order_seq_cst, std::memory_order_seq_cst))
+                return;
+        }
+    }
+}
+
+#endif // GUARD_NOE_STD_concurrent_vector_H
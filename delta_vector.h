@@ -0,0 +1,172 @@
+/**
+ * NoException Standard Library Container Implementation
+ * by Marvin Manese 2017
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+#ifndef GUARD_NOE_STD_delta_vector_H
+#define GUARD_NOE_STD_delta_vector_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include "allocator.h"
+#include "macro.h"
+#include "packed_int_vector.h"
+#include "simd_algorithm.h"
+#include "vector.h"
+
+namespace noe_std
+{
+namespace detail
+{
+    /// Frame of reference of one sealed block: its values are base + a width bit delta
+    struct delta_block
+    {
+        std::uint64_t   m_base;
+        std::uint64_t   m_first_bit;
+        unsigned        m_width;
+    };
+}
+    /// Append only integer column compressed in blocks of BlockSize values. A full block is sealed into
+    /// frame of reference form: the block minimum is kept as its base and every value as a delta from
+    /// it in just enough bits for the block's range, so clustered or monotonically growing values
+    /// (ids, timestamps) shrink to a few bits each. The last, unsealed block stays uncompressed.
+    /// Random access reads one block header and one packed field, decode and the iterator unpack
+    /// whole runs with the SIMD kernel and add the base in a vectorizable loop.
+    /// push_back returns false (and leaves the vector untouched) if allocation fails.
+    template<std::size_t BlockSize = 128, class AllocatorT = allocator<std::uint64_t> >
+    class delta_vector
+    {
+        typedef typename std::allocator_traits<AllocatorT>::template rebind_alloc<detail::delta_block>   block_allocator_t;
+
+    public:
+        typedef std::uint64_t                               value_type;
+        typedef std::size_t                                 size_type;
+        typedef detail::packed_iterator<delta_vector>       const_iterator;
+        typedef const_iterator                              iterator;
+
+        enum : size_type { block_size = BlockSize };
+
+        delta_vector() noe_std_no_except : m_bit_size(0) {}
+
+        size_type size() const noe_std_no_except { return m_blocks.size() * BlockSize + m_tail.size(); }
+        bool empty() const noe_std_no_except { return size() == 0; }
+        size_type memory_bytes() const noe_std_no_except;
+        void shrink_to_fit() { m_bits.shrink_to_fit(); m_blocks.shrink_to_fit(); }
+        void clear() { m_bits.clear(); m_blocks.clear(); m_tail.clear(); m_bit_size = 0; }
+
+        value_type operator[](size_type n) const noe_std_no_except;
+        value_type get(size_type n) const noe_std_no_except { return (*this)[n]; }
+        bool push_back(value_type value);
+
+        // writes the n values from first on to out
+        void decode(size_type first, size_type n, value_type* out) const noe_std_no_except;
+        const_iterator begin() const { return const_iterator(this, 0); }
+        const_iterator end() const { return const_iterator(this, size()); }
+
+    private:
+        bool seal();
+
+        vector<std::uint64_t, AllocatorT> m_bits;   // packed deltas of every sealed block, plus a zero padding word
+        vector<detail::delta_block, block_allocator_t> m_blocks;
+        vector<std::uint64_t, AllocatorT> m_tail;   // unsealed values
+        size_type m_bit_size;
+    };
+
+    template<std::size_t BlockSize, class AllocatorT>
+    typename delta_vector<BlockSize, AllocatorT>::size_type delta_vector<BlockSize, AllocatorT>::memory_bytes() const noe_std_no_except
+    {
+        return m_bits.capacity() * sizeof(std::uint64_t) + m_blocks.capacity() * sizeof(detail::delta_block) +
+               m_tail.capacity() * sizeof(std::uint64_t);
+    }
+
+    template<std::size_t BlockSize, class AllocatorT>
+    typename delta_vector<BlockSize, AllocatorT>::value_type delta_vector<BlockSize, AllocatorT>::operator[](size_type n) const noe_std_no_except
+    {
+        size_type block = n / BlockSize;
+        if(block >= m_blocks.size())
+            return m_tail[n - m_blocks.size() * BlockSize];
+        const detail::delta_block& header = m_blocks[block];
+        return header.m_base + detail::packed_read(m_bits.data(), header.m_first_bit + (n % BlockSize) * header.m_width, header.m_width);
+    }
+
+    template<std::size_t BlockSize, class AllocatorT>
+    bool delta_vector<BlockSize, AllocatorT>::push_back(value_type value)
+    {
+        if(!m_tail.push_back(value))
+            return false;
+        if(m_tail.size() == BlockSize && !seal()) {
+            m_tail.pop_back();
+            return false;
+        }
+        return true;
+    }
+
+    template<std::size_t BlockSize, class AllocatorT>
+    void delta_vector<BlockSize, AllocatorT>::decode(size_type first, size_type n, value_type* out) const noe_std_no_except
+    {
+        size_type sealed = m_blocks.size() * BlockSize;
+        while(n && first < sealed) {
+            // the rest of one block per step
+            const detail::delta_block& header = m_blocks[first / BlockSize];
+            size_type offset = first % BlockSize;
+            size_type count = BlockSize - offset < n ? BlockSize - offset : n;
+            simd::unpack_bits(m_bits.data(), header.m_first_bit + offset * header.m_width, header.m_width, count, out);
+            std::uint64_t base = header.m_base;
+            for(size_type i = 0; i < count; ++i)
+                out[i] += base;
+            first += count;
+            out += count;
+            n -= count;
+        }
+        for(size_type i = 0; i < n; ++i)
+            out[i] = m_tail[first - sealed + i];
+    }
+
+    template<std::size_t BlockSize, class AllocatorT>
+    bool delta_vector<BlockSize, AllocatorT>::seal()
+    {
+        std::uint64_t min = m_tail[0], max = m_tail[0];
+        for(size_type i = 1; i < BlockSize; ++i) {
+            min = m_tail[i] < min ? m_tail[i] : min;
+            max = m_tail[i] > max ? m_tail[i] : max;
+        }
+        unsigned width = packed_int_vector<>::bits_for(max - min);
+        detail::delta_block header = { min, m_bit_size, width };
+        if(!m_blocks.push_back(header))
+            return false;
+        // the old padding word becomes part of the block, a new zero one follows it
+        size_type old_words = m_bits.size();
+        size_type new_words = detail::packed_words(m_bit_size + BlockSize * width) + 1;
+        if(!m_bits.resize_default_init(new_words)) {
+            m_blocks.pop_back();
+            return false;
+        }
+        for(size_type i = old_words; i < new_words; ++i)
+            m_bits[i] = 0;
+        for(size_type i = 0; i < BlockSize; ++i)
+            detail::packed_write(m_bits.data(), m_bit_size + i * width, width, m_tail[i] - min);
+        m_bit_size += BlockSize * width;
+        m_tail.clear();
+        return true;
+    }
+}
+
+#endif // GUARD_NOE_STD_delta_vector_H
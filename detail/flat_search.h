@@ -0,0 +1,157 @@
+/**
+ * NoException Standard Library Container Implementation
+ * by Marvin Manese 2017
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+#ifndef GUARD_NOE_STD_detail_flat_search_H
+#define GUARD_NOE_STD_detail_flat_search_H
+
+#include <cstddef>
+#include "allocator.h"
+#include "macro.h"
+#include "vector.h"
+
+namespace noe_std
+{
+namespace detail
+{
+    /// lower_bound over a sorted array without a data dependent branch, the loop runs
+    /// ceil(log2(n)) times and the compiler turns the step into a conditional move
+    template<class K, class Compare>
+    std::size_t branchless_lower_bound(const K* data, std::size_t n, const K& key, const Compare& comp)
+    {
+        if(n == 0)
+            return 0;
+        const K* base = data;
+        while(n > 1) {
+            std::size_t half = n / 2;
+            base = comp(base[half], key) ? base + half : base;
+            n -= half;
+        }
+        return static_cast<std::size_t>(base - data) + comp(*base, key);
+    }
+
+    inline unsigned flat_search_ctz(std::size_t word) noe_std_no_except
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<unsigned>(__builtin_ctzll(word));
+#else
+        unsigned n = 0;
+        for(; !(word & 1); word >>= 1)
+            ++n;
+        return n;
+#endif // __GNUC__ || __clang__
+    }
+
+    /// Read only copy of a sorted key array in Eytzinger (breadth first) order. The top levels of the
+    /// implicit tree share a few cache lines and the descendants of a node are contiguous, so they can be
+    /// prefetched a few levels ahead; on tables much larger than the cache this beats binary search.
+    /// Node k (1 based) is stored at m_keys[k - 1], m_ranks maps it back to its position in the sorted array.
+    template<class K, class AllocatorT = allocator<K> >
+    class eytzinger_index
+    {
+    public:
+        typedef std::size_t size_type;
+
+        eytzinger_index() {}
+        // the index is left empty if allocation fails
+        eytzinger_index(const eytzinger_index& rhs);
+        eytzinger_index& operator=(const eytzinger_index& rhs) { eytzinger_index tmp(rhs); swap(tmp); return *this; }
+        eytzinger_index(eytzinger_index&& rhs) = default;
+        eytzinger_index& operator=(eytzinger_index&& rhs) = default;
+
+        size_type size() const noe_std_no_except { return m_keys.size(); }
+        void clear() { m_keys.clear(); m_ranks.clear(); }
+        void swap(eytzinger_index& other) noe_std_no_except { m_keys.swap(other.m_keys); m_ranks.swap(other.m_ranks); }
+
+        // false (and the index left empty) if allocation fails
+        bool build(const K* sorted, size_type n);
+        // position of the first key in the sorted array not less than key, size() if there is none
+        template<class Compare>
+        size_type lower_bound(const K& key, const Compare& comp) const;
+
+    private:
+        typedef typename AllocatorT::template rebind<size_type>::other rank_allocator_t;
+
+        size_type fill_ranks(size_type k, size_type rank, size_type n);
+
+        vector<K, AllocatorT> m_keys;
+        vector<size_type, rank_allocator_t> m_ranks;
+    };
+
+    template<class K, class AllocatorT>
+    eytzinger_index<K, AllocatorT>::eytzinger_index(const eytzinger_index& rhs) :
+        m_keys(rhs.m_keys), m_ranks(rhs.m_ranks)
+    {
+        // each vector comes back empty if its allocation failed, never keep one without the other
+        if(m_keys.size() != rhs.m_keys.size() || m_ranks.size() != rhs.m_ranks.size())
+            clear();
+    }
+
+    template<class K, class AllocatorT>
+    bool eytzinger_index<K, AllocatorT>::build(const K* sorted, size_type n)
+    {
+        clear();
+        if(!m_ranks.resize_default_init(n))
+            return false;
+        fill_ranks(1, 0, n);
+        for(size_type k = 0; k < n; ++k) {
+            if(!m_keys.push_back(sorted[m_ranks[k]])) {
+                clear();
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template<class K, class AllocatorT>
+    typename eytzinger_index<K, AllocatorT>::size_type eytzinger_index<K, AllocatorT>::fill_ranks(size_type k, size_type rank, size_type n)
+    {
+        // in order walk of the implicit tree hands out the sorted positions, depth is log2(n)
+        if(k > n)
+            return rank;
+        rank = fill_ranks(2 * k, rank, n);
+        m_ranks[k - 1] = rank++;
+        return fill_ranks(2 * k + 1, rank, n);
+    }
+
+    template<class K, class AllocatorT>
+    template<class Compare>
+    typename eytzinger_index<K, AllocatorT>::size_type eytzinger_index<K, AllocatorT>::lower_bound(const K& key, const Compare& comp) const
+    {
+        const K* keys = m_keys.data();
+        size_type n = m_keys.size();
+        size_type k = 1;
+        while(k <= n) {
+#if defined(__GNUC__) || defined(__clang__)
+            // the 16 descendants four levels down are adjacent
+            if(16 * k <= n)
+                __builtin_prefetch(keys + 16 * k - 1);
+#endif // __GNUC__ || __clang__
+            k = 2 * k + comp(keys[k - 1], key);
+        }
+        // undo the trailing right turns plus the last left turn, k becomes the lower bound node
+        k >>= flat_search_ctz(~k) + 1;
+        return k ? m_ranks[k - 1] : n;
+    }
+}
+}
+
+#endif // GUARD_NOE_STD_detail_flat_search_H
@@ -0,0 +1,93 @@
+/**
+ * NoException Standard Library Container Implementation
+ * by Marvin Manese 2017
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+#ifndef GUARD_NOE_STD_detail_indexed_iterator_H
+#define GUARD_NOE_STD_detail_indexed_iterator_H
+
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+
+namespace noe_std
+{
+namespace detail
+{
+    /// Reads element i with the container's index operator
+    struct indexed_subscript
+    {
+        template<class Reference, class ContainerT>
+        static Reference get(ContainerT& c, std::size_t i) { return c[i]; }
+    };
+
+    /// Random access iterator holding a container pointer and an index, for containers whose
+    /// elements are not in one array (segments, rings, tries) or are read through a proxy.
+    /// Pointer is void when Reference is a proxy returned by value, AccessT reads element i.
+    template<class ContainerT, class Reference, class Pointer = void, class AccessT = indexed_subscript>
+    class indexed_iterator
+    {
+    public:
+        typedef std::random_access_iterator_tag         iterator_category;
+        typedef typename ContainerT::value_type         value_type;
+        typedef std::ptrdiff_t                          difference_type;
+        typedef Reference                               reference;
+        typedef Pointer                                 pointer;
+
+        indexed_iterator() : m_container(0), m_index(0) {}
+        indexed_iterator(ContainerT* container, std::size_t index) : m_container(container), m_index(index) {}
+        // iterator to const_iterator
+        template<class C, class R, class P,
+                 class = typename std::enable_if<std::is_convertible<C*, ContainerT*>::value>::type>
+        indexed_iterator(const indexed_iterator<C, R, P, AccessT>& rhs) : m_container(rhs.m_container), m_index(rhs.m_index) {}
+
+        reference operator*() const { return AccessT::template get<reference>(*m_container, m_index); }
+        pointer operator->() const { return &AccessT::template get<reference>(*m_container, m_index); }
+        reference operator[](difference_type n) const { return AccessT::template get<reference>(*m_container, m_index + n); }
+        std::size_t index() const { return m_index; }
+
+        indexed_iterator& operator++() { ++m_index; return *this; }
+        indexed_iterator operator++(int) { indexed_iterator it(*this); ++m_index; return it; }
+        indexed_iterator& operator--() { --m_index; return *this; }
+        indexed_iterator operator--(int) { indexed_iterator it(*this); --m_index; return it; }
+        indexed_iterator& operator+=(difference_type n) { m_index += n; return *this; }
+        indexed_iterator& operator-=(difference_type n) { m_index -= n; return *this; }
+        friend indexed_iterator operator+(indexed_iterator it, difference_type n) { return it += n; }
+        friend indexed_iterator operator+(difference_type n, indexed_iterator it) { return it += n; }
+        friend indexed_iterator operator-(indexed_iterator it, difference_type n) { return it -= n; }
+        friend difference_type operator-(const indexed_iterator& lhs, const indexed_iterator& rhs) { return difference_type(lhs.m_index) - difference_type(rhs.m_index); }
+
+        friend bool operator==(const indexed_iterator& lhs, const indexed_iterator& rhs) { return lhs.m_index == rhs.m_index; }
+        friend bool operator!=(const indexed_iterator& lhs, const indexed_iterator& rhs) { return lhs.m_index != rhs.m_index; }
+        friend bool operator<(const indexed_iterator& lhs, const indexed_iterator& rhs) { return lhs.m_index < rhs.m_index; }
+        friend bool operator<=(const indexed_iterator& lhs, const indexed_iterator& rhs) { return lhs.m_index <= rhs.m_index; }
+        friend bool operator>(const indexed_iterator& lhs, const indexed_iterator& rhs) { return lhs.m_index > rhs.m_index; }
+        friend bool operator>=(const indexed_iterator& lhs, const indexed_iterator& rhs) { return lhs.m_index >= rhs.m_index; }
+
+    private:
+        template<class C, class R, class P, class A> friend class indexed_iterator;
+
+        ContainerT*     m_container;
+        std::size_t     m_index;
+    };
+}
+}
+
+#endif // GUARD_NOE_STD_detail_indexed_iterator_H
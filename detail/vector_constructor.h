@@ -0,0 +1,73 @@
+/**
+ * NoException Standard Library Container Implementation
+ * by Marvin Manese 2017
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+#ifndef GUARD_NOE_STD_detail_vector_constructor_H
+#define GUARD_NOE_STD_detail_vector_constructor_H
+
+#include <new>
+#include <utility>
+
+namespace noe_std
+{
+namespace detail
+{
+    /// Constructs every inserted element as a copy of the same value
+    template<class T>
+    struct vector_fill_constructor
+    {
+        explicit vector_fill_constructor(const T& v) : m_value(v) {}
+
+        template<class Allocator, class Pointer>
+        void operator()(Allocator& alloc, Pointer p) { alloc.construct(p, m_value); }
+
+        const T& m_value;
+    };
+
+    /// Constructs inserted elements from consecutive positions of a forward range
+    template<class ForwardIt>
+    struct vector_range_constructor
+    {
+        explicit vector_range_constructor(ForwardIt it) : m_it(it) {}
+
+        template<class Allocator, class Pointer>
+        void operator()(Allocator& alloc, Pointer p) { alloc.construct(p, *m_it); ++m_it; }
+
+        ForwardIt m_it;
+    };
+
+    /// Stand-in allocator for containers that construct directly into their own storage
+    struct placement_constructor
+    {
+#if __cplusplus >= 201103L
+        template<class U, class... Args>
+        void construct(U* p, Args&&... args) { new(static_cast<void*>(p)) U(std::forward<Args>(args)...); }
+#else
+        template<class U>
+        void construct(U* p, const U& u) { new(static_cast<void*>(p)) U(u); }
+#endif // __cplusplus >= 201103L
+        template<class U>
+        void destroy(U* p) { p->~U(); }
+    };
+}
+}
+
+#endif // GUARD_NOE_STD_detail_vector_constructor_H
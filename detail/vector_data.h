@@ -0,0 +1,170 @@
+/**
+ * NoException Standard Library Container Implementation
+ * by Marvin Manese 2017
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+#ifndef GUARD_NOE_STD_detail_vector_data_H
+#define GUARD_NOE_STD_detail_vector_data_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+#include "../type_traits.h"
+
+namespace noe_std
+{
+namespace detail
+{
+    /// Element shuffling shared by the contiguous containers (vector, static_vector).
+    /// Each routine works on a raw buffer and its element count, alloc only has to construct and
+    /// destroy (an allocator or a placement_constructor).
+
+    template<class Allocator, class T, class SizeT>
+    inline void vector_clear_data(Allocator&, T*, SizeT, std::true_type)
+    {
+        // nothing to destroy
+    }
+
+    template<class Allocator, class T, class SizeT>
+    void vector_clear_data(Allocator& alloc, T* data, SizeT size, std::false_type)
+    {
+        // destroy top most
+        while(size)
+            alloc.destroy(data + (--size));
+    }
+
+    /// Destroys [data, data + size)
+    template<class Allocator, class T, class SizeT>
+    inline void vector_clear_data(Allocator& alloc, T* data, SizeT size)
+    {
+        vector_clear_data(alloc, data, size, std::integral_constant<bool, std::is_trivially_destructible<T>::value>());
+    }
+
+    template<class Allocator, class T, class SizeT, class Constructor>
+    void vector_insert_in_place(Allocator& alloc, T* data, SizeT& size, std::size_t index, std::size_t n, Constructor& ctor, std::true_type)
+    {
+        T* pos = data + index;
+        std::size_t tail = size - index;
+        if(tail > 0)
+            std::memmove(static_cast<void*>(pos + n), static_cast<const void*>(pos), tail * sizeof(T));
+        for(std::size_t i = 0; i < n; ++i)
+            ctor(alloc, pos + i);
+        size += n;
+    }
+
+    template<class Allocator, class T, class SizeT, class Constructor>
+    void vector_insert_in_place(Allocator& alloc, T* data, SizeT& size, std::size_t index, std::size_t n, Constructor& ctor, std::false_type)
+    {
+        // construct behind the last element, then rotate the tail past the new elements
+        SizeT old_size = size;
+        for(std::size_t i = 0; i < n; ++i) {
+            ctor(alloc, data + size);
+            ++size;
+        }
+        std::rotate(data + index, data + old_size, data + size);
+    }
+
+    /// Constructs n elements with ctor at index, the buffer must have room for them
+    template<class Allocator, class T, class SizeT, class Constructor>
+    inline void vector_insert_in_place(Allocator& alloc, T* data, SizeT& size, std::size_t index, std::size_t n, Constructor& ctor)
+    {
+        vector_insert_in_place(alloc, data, size, index, n, ctor, std::integral_constant<bool, is_trivially_relocatable<T>::value>());
+    }
+
+    template<class Allocator, class T, class SizeT>
+    void vector_erase_data(Allocator& alloc, T* data, SizeT& size, T* first, T* last, std::true_type)
+    {
+        std::size_t count = last - first;
+        if(count == 0)
+            return;
+
+        T* end = data + size;
+        vector_clear_data(alloc, first, count);
+        if(last != end)
+            std::memmove(static_cast<void*>(first), static_cast<const void*>(last), (end - last) * sizeof(T));
+        size -= count;
+    }
+
+    template<class Allocator, class T, class SizeT>
+    void vector_erase_data(Allocator& alloc, T* data, SizeT& size, T* first, T* last, std::false_type)
+    {
+        std::size_t count = last - first;
+        if(count == 0)
+            return;
+
+        T* end = data + size;
+        std::move(last, end, first);
+        vector_clear_data(alloc, end - count, count);
+        size -= count;
+    }
+
+    /// Removes [first, last)
+    template<class Allocator, class T, class SizeT>
+    inline void vector_erase_data(Allocator& alloc, T* data, SizeT& size, T* first, T* last)
+    {
+        vector_erase_data(alloc, data, size, first, last, std::integral_constant<bool, is_trivially_relocatable<T>::value>());
+    }
+
+    template<class Allocator, class T, class SizeT, class Pred>
+    SizeT vector_erase_if_data(Allocator& alloc, T* data, SizeT& size, Pred& pred, std::true_type)
+    {
+        // destroy matches as they are found and slide every run of kept elements down with one memmove
+        T* end = data + size;
+        T* write = data;
+        for(T* read = data; read != end;) {
+            T* run = read;
+            while(read != end && !pred(*read))
+                ++read;
+            std::size_t run_size = read - run;
+            if(run_size > 0 && write != run)
+                std::memmove(static_cast<void*>(write), static_cast<const void*>(run), run_size * sizeof(T));
+            write += run_size;
+            if(read != end) { // pred(*read) was true
+                alloc.destroy(read);
+                ++read;
+            }
+        }
+        SizeT removed = end - write;
+        size -= removed;
+        return removed;
+    }
+
+    template<class Allocator, class T, class SizeT, class Pred>
+    SizeT vector_erase_if_data(Allocator& alloc, T* data, SizeT& size, Pred& pred, std::false_type)
+    {
+        T* end = data + size;
+        T* new_end = std::remove_if(data, end, pred);
+        SizeT removed = end - new_end;
+        vector_clear_data(alloc, new_end, removed);
+        size -= removed;
+        return removed;
+    }
+
+    /// Removes every element satisfying pred in a single pass, returns the number of removed elements
+    template<class Allocator, class T, class SizeT, class Pred>
+    inline SizeT vector_erase_if_data(Allocator& alloc, T* data, SizeT& size, Pred& pred)
+    {
+        return vector_erase_if_data(alloc, data, size, pred, std::integral_constant<bool, is_trivially_relocatable<T>::value>());
+    }
+}
+}
+
+#endif // GUARD_NOE_STD_detail_vector_data_H
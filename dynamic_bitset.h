@@ -0,0 +1,336 @@
+/**
+ * NoException Standard Library Container Implementation
+ * by Marvin Manese 2017
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+#ifndef GUARD_NOE_STD_dynamic_bitset_H
+#define GUARD_NOE_STD_dynamic_bitset_H
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include "allocator.h"
+#include "growth_policy.h"
+#include "macro.h"
+#include "simd_algorithm.h"
+#include "vector.h"
+
+/// Bit set packed into 64 bit words on top of noe_std::vector, for membership bitmaps where
+/// vector<bool> would spend a byte per element. Bits past size() in the last word are kept zero,
+/// so whole word operations (count, bulk and / or / xor, comparison) never need masking.
+/// Growing operations return false (and leave the set untouched) when allocation fails.
+namespace noe_std
+{
+namespace detail
+{
+    inline unsigned bitset_ctz(std::uint64_t word) noe_std_no_except
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<unsigned>(__builtin_ctzll(word));
+#else
+        unsigned n = 0;
+        for(; !(word & 1); word >>= 1)
+            ++n;
+        return n;
+#endif // __GNUC__ || __clang__
+    }
+}
+    template<class AllocatorT = allocator<std::uint64_t>,
+             class GrowthPolicyT = double_growth_policy>
+    class dynamic_bitset
+    {
+    public:
+        typedef std::uint64_t                                   word_type;
+        typedef std::size_t                                     size_type;
+        typedef vector<word_type, AllocatorT, GrowthPolicyT>    word_vector;
+
+        enum : size_type { bits_per_word = 64 };
+        static const size_type npos = static_cast<size_type>(-1);
+
+        dynamic_bitset() noe_std_no_except : m_size(0) {}
+        // the copy is left empty if allocation fails
+        dynamic_bitset(const dynamic_bitset& rhs);
+        dynamic_bitset& operator=(const dynamic_bitset& rhs);
+        dynamic_bitset(dynamic_bitset&& rhs) noe_std_no_except : m_size(0) { swap(rhs); }
+        dynamic_bitset& operator=(dynamic_bitset&& rhs) noe_std_no_except { swap(rhs); return *this; }
+
+        size_type size() const noe_std_no_except { return m_size; }
+        bool empty() const noe_std_no_except { return m_size == 0; }
+        size_type capacity() const noe_std_no_except { return m_words.capacity() * bits_per_word; }
+        size_type num_words() const noe_std_no_except { return m_words.size(); }
+        void reserve(size_type n) { m_words.reserve(word_count(n)); }
+        void shrink_to_fit() { m_words.shrink_to_fit(); }
+        void clear() { m_words.clear(); m_size = 0; }
+        void swap(dynamic_bitset& other) noe_std_no_except;
+
+        // new bits take value
+        bool resize(size_type n, bool value = false);
+        bool push_back(bool value);
+        void pop_back() noe_std_no_except { resize_down(m_size - 1); }
+
+        bool test(size_type i) const noe_std_no_except { return (m_words[i / bits_per_word] >> (i % bits_per_word)) & 1; }
+        bool operator[](size_type i) const noe_std_no_except { return test(i); }
+        void set(size_type i) noe_std_no_except { m_words[i / bits_per_word] |= bit_mask(i); }
+        void set(size_type i, bool value) noe_std_no_except { value ? set(i) : reset(i); }
+        void reset(size_type i) noe_std_no_except { m_words[i / bits_per_word] &= ~bit_mask(i); }
+        void flip(size_type i) noe_std_no_except { m_words[i / bits_per_word] ^= bit_mask(i); }
+        void set() noe_std_no_except;
+        void reset() noe_std_no_except;
+        void flip() noe_std_no_except;
+        // [first, last), whole words are written at once
+        void set_range(size_type first, size_type last, bool value = true) noe_std_no_except;
+        void flip_range(size_type first, size_type last) noe_std_no_except;
+
+        // raw word access, set_word drops bits past size()
+        word_type word(size_type w) const noe_std_no_except { return m_words[w]; }
+        void set_word(size_type w, word_type value) noe_std_no_except;
+        const word_type* words() const noe_std_no_except { return m_words.data(); }
+
+        size_type count() const noe_std_no_except { return simd::popcount(m_words.data(), m_words.size()); }
+        bool any() const noe_std_no_except { return find_first() != npos; }
+        bool none() const noe_std_no_except { return !any(); }
+        bool all() const noe_std_no_except { return count() == m_size; }
+        // index of the first set bit (after i for find_next), npos if there is none
+        size_type find_first() const noe_std_no_except { return find_from(0); }
+        size_type find_next(size_type i) const noe_std_no_except { return i + 1 >= m_size ? npos : find_from(i + 1); }
+
+        // bulk operations, false (and nothing changed) if the sizes differ
+        bool bit_and(const dynamic_bitset& rhs) noe_std_no_except;
+        bool bit_or(const dynamic_bitset& rhs) noe_std_no_except;
+        bool bit_xor(const dynamic_bitset& rhs) noe_std_no_except;
+        bool bit_andnot(const dynamic_bitset& rhs) noe_std_no_except;   // this &= ~rhs
+
+        friend bool operator==(const dynamic_bitset& lhs, const dynamic_bitset& rhs) noe_std_no_except
+        {
+            return lhs.m_size == rhs.m_size && simd::equal(lhs.m_words.data(), rhs.m_words.data(), lhs.m_words.size());
+        }
+        friend bool operator!=(const dynamic_bitset& lhs, const dynamic_bitset& rhs) noe_std_no_except { return !(lhs == rhs); }
+
+    private:
+        static size_type word_count(size_type bits) noe_std_no_except { return bits / bits_per_word + (bits % bits_per_word != 0); }
+        static word_type bit_mask(size_type i) noe_std_no_except { return word_type(1) << (i % bits_per_word); }
+        // bits [i % 64, 64) of a word
+        static word_type high_mask(size_type i) noe_std_no_except { return ~word_type(0) << (i % bits_per_word); }
+        void clear_tail() noe_std_no_except;
+        void resize_down(size_type n) noe_std_no_except;
+        size_type find_from(size_type i) const noe_std_no_except;
+
+        word_vector m_words;
+        size_type m_size;
+    };
+
+    template<class AllocatorT, class GrowthPolicyT>
+    const typename dynamic_bitset<AllocatorT, GrowthPolicyT>::size_type dynamic_bitset<AllocatorT, GrowthPolicyT>::npos;
+
+    template<class AllocatorT, class GrowthPolicyT>
+    dynamic_bitset<AllocatorT, GrowthPolicyT>::dynamic_bitset(const dynamic_bitset& rhs) :
+        m_words(rhs.m_words), m_size(rhs.m_size)
+    {
+        // the words come back empty if their allocation failed
+        if(m_words.size() != rhs.m_words.size())
+            clear();
+    }
+
+    template<class AllocatorT, class GrowthPolicyT>
+    dynamic_bitset<AllocatorT, GrowthPolicyT>& dynamic_bitset<AllocatorT, GrowthPolicyT>::operator=(const dynamic_bitset& rhs)
+    {
+        dynamic_bitset tmp(rhs);
+        swap(tmp);
+        return *this;
+    }
+
+    template<class AllocatorT, class GrowthPolicyT>
+    void dynamic_bitset<AllocatorT, GrowthPolicyT>::swap(dynamic_bitset& other) noe_std_no_except
+    {
+        m_words.swap(other.m_words);
+        size_type size = m_size;
+        m_size = other.m_size;
+        other.m_size = size;
+    }
+
+    template<class AllocatorT, class GrowthPolicyT>
+    bool dynamic_bitset<AllocatorT, GrowthPolicyT>::resize(size_type n, bool value)
+    {
+        if(n <= m_size) {
+            resize_down(n);
+            return true;
+        }
+        size_type old_words = m_words.size();
+        if(!m_words.resize_default_init(word_count(n)))
+            return false;
+        word_type fill = value ? ~word_type(0) : word_type(0);
+        for(size_type w = old_words; w < m_words.size(); ++w)
+            m_words[w] = fill;
+        if(value && m_size % bits_per_word)
+            m_words[old_words - 1] |= high_mask(m_size);
+        m_size = n;
+        clear_tail();
+        return true;
+    }
+
+    template<class AllocatorT, class GrowthPolicyT>
+    bool dynamic_bitset<AllocatorT, GrowthPolicyT>::push_back(bool value)
+    {
+        if(m_size % bits_per_word == 0 && !m_words.push_back(word_type(0)))
+            return false;
+        ++m_size;
+        set(m_size - 1, value);
+        return true;
+    }
+
+    template<class AllocatorT, class GrowthPolicyT>
+    void dynamic_bitset<AllocatorT, GrowthPolicyT>::set() noe_std_no_except
+    {
+        for(size_type w = 0; w < m_words.size(); ++w)
+            m_words[w] = ~word_type(0);
+        clear_tail();
+    }
+
+    template<class AllocatorT, class GrowthPolicyT>
+    void dynamic_bitset<AllocatorT, GrowthPolicyT>::reset() noe_std_no_except
+    {
+        for(size_type w = 0; w < m_words.size(); ++w)
+            m_words[w] = 0;
+    }
+
+    template<class AllocatorT, class GrowthPolicyT>
+    void dynamic_bitset<AllocatorT, GrowthPolicyT>::flip() noe_std_no_except
+    {
+        for(size_type w = 0; w < m_words.size(); ++w)
+            m_words[w] = ~m_words[w];
+        clear_tail();
+    }
+
+    template<class AllocatorT, class GrowthPolicyT>
+    void dynamic_bitset<AllocatorT, GrowthPolicyT>::set_range(size_type first, size_type last, bool value) noe_std_no_except
+    {
+        if(first >= last)
+            return;
+        size_type first_word = first / bits_per_word;
+        size_type last_word = (last - 1) / bits_per_word;
+        word_type first_mask = high_mask(first);
+        word_type last_mask = ~word_type(0) >> (bits_per_word - 1 - (last - 1) % bits_per_word);
+        if(first_word == last_word)
+            first_mask &= last_mask;
+        word_type fill = value ? ~word_type(0) : word_type(0);
+        m_words[first_word] = (m_words[first_word] & ~first_mask) | (fill & first_mask);
+        if(first_word == last_word)
+            return;
+        for(size_type w = first_word + 1; w < last_word; ++w)
+            m_words[w] = fill;
+        m_words[last_word] = (m_words[last_word] & ~last_mask) | (fill & last_mask);
+    }
+
+    template<class AllocatorT, class GrowthPolicyT>
+    void dynamic_bitset<AllocatorT, GrowthPolicyT>::flip_range(size_type first, size_type last) noe_std_no_except
+    {
+        if(first >= last)
+            return;
+        size_type first_word = first / bits_per_word;
+        size_type last_word = (last - 1) / bits_per_word;
+        word_type first_mask = high_mask(first);
+        word_type last_mask = ~word_type(0) >> (bits_per_word - 1 - (last - 1) % bits_per_word);
+        if(first_word == last_word) {
+            m_words[first_word] ^= first_mask & last_mask;
+            return;
+        }
+        m_words[first_word] ^= first_mask;
+        for(size_type w = first_word + 1; w < last_word; ++w)
+            m_words[w] = ~m_words[w];
+        m_words[last_word] ^= last_mask;
+    }
+
+    template<class AllocatorT, class GrowthPolicyT>
+    void dynamic_bitset<AllocatorT, GrowthPolicyT>::set_word(size_type w, word_type value) noe_std_no_except
+    {
+        m_words[w] = value;
+        if(w + 1 == m_words.size())
+            clear_tail();
+    }
+
+    template<class AllocatorT, class GrowthPolicyT>
+    inline bool dynamic_bitset<AllocatorT, GrowthPolicyT>::bit_and(const dynamic_bitset& rhs) noe_std_no_except
+    {
+        if(m_size != rhs.m_size)
+            return false;
+        simd::bit_and(m_words.data(), rhs.m_words.data(), m_words.size());
+        return true;
+    }
+
+    template<class AllocatorT, class GrowthPolicyT>
+    inline bool dynamic_bitset<AllocatorT, GrowthPolicyT>::bit_or(const dynamic_bitset& rhs) noe_std_no_except
+    {
+        if(m_size != rhs.m_size)
+            return false;
+        simd::bit_or(m_words.data(), rhs.m_words.data(), m_words.size());
+        return true;
+    }
+
+    template<class AllocatorT, class GrowthPolicyT>
+    inline bool dynamic_bitset<AllocatorT, GrowthPolicyT>::bit_xor(const dynamic_bitset& rhs) noe_std_no_except
+    {
+        if(m_size != rhs.m_size)
+            return false;
+        simd::bit_xor(m_words.data(), rhs.m_words.data(), m_words.size());
+        return true;
+    }
+
+    template<class AllocatorT, class GrowthPolicyT>
+    inline bool dynamic_bitset<AllocatorT, GrowthPolicyT>::bit_andnot(const dynamic_bitset& rhs) noe_std_no_except
+    {
+        if(m_size != rhs.m_size)
+            return false;
+        simd::bit_andnot(m_words.data(), rhs.m_words.data(), m_words.size());
+        return true;
+    }
+
+    template<class AllocatorT, class GrowthPolicyT>
+    inline void dynamic_bitset<AllocatorT, GrowthPolicyT>::clear_tail() noe_std_no_except
+    {
+        if(m_size % bits_per_word)
+            m_words[m_words.size() - 1] &= ~high_mask(m_size);
+    }
+
+    template<class AllocatorT, class GrowthPolicyT>
+    void dynamic_bitset<AllocatorT, GrowthPolicyT>::resize_down(size_type n) noe_std_no_except
+    {
+        // shrinking never allocates
+        m_words.resize_default_init(word_count(n));
+        m_size = n;
+        clear_tail();
+    }
+
+    template<class AllocatorT, class GrowthPolicyT>
+    typename dynamic_bitset<AllocatorT, GrowthPolicyT>::size_type dynamic_bitset<AllocatorT, GrowthPolicyT>::find_from(size_type i) const noe_std_no_except
+    {
+        if(i >= m_size)
+            return npos;
+        size_type w = i / bits_per_word;
+        word_type word = m_words[w] & high_mask(i);
+        while(!word) {
+            if(++w == m_words.size())
+                return npos;
+            word = m_words[w];
+        }
+        return w * bits_per_word + detail::bitset_ctz(word);
+    }
+}
+
+#endif // GUARD_NOE_STD_dynamic_bitset_H
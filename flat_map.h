@@ -0,0 +1,306 @@
+/**
+ * NoException Standard Library Container Implementation
+ * by Marvin Manese 2017
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+#ifndef GUARD_NOE_STD_flat_map_H
+#define GUARD_NOE_STD_flat_map_H
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <utility>
+#include "allocator.h"
+#include "macro.h"
+#include "vector.h"
+#include "detail/flat_search.h"
+#include "detail/indexed_iterator.h"
+
+namespace noe_std
+{
+namespace detail
+{
+    /// Iterators of a flat_map dereference to a pair of references into the key and value arrays
+    struct flat_map_entry_access
+    {
+        template<class Reference, class MapT>
+        static Reference get(MapT& map, std::size_t i) { return map.entry(i); }
+    };
+}
+    /// Sorted map with the keys and the values in two separate noe_std::vector, so a lookup only
+    /// touches the dense key array (branchless binary search) and the value is read once at the end.
+    /// Like flat_set it is meant for read mostly tables: assign builds it in bulk from unsorted input
+    /// with one sort, build_index adds an Eytzinger copy of the keys for very large immutable tables.
+    /// Insertions return false (and leave the map untouched) if allocation fails.
+    template<class K,
+             class V,
+             class Compare = std::less<K>,
+             class KeyAllocatorT = allocator<K>,
+             class ValueAllocatorT = allocator<V> >
+    class flat_map
+    {
+    public:
+        typedef K                                                           key_type;
+        typedef V                                                           mapped_type;
+        typedef std::pair<K, V>                                             value_type;
+        typedef Compare                                                     key_compare;
+        typedef std::size_t                                                 size_type;
+        typedef std::pair<const K&, V&>                                     reference;
+        typedef std::pair<const K&, const V&>                               const_reference;
+        typedef detail::indexed_iterator<flat_map, reference, void, detail::flat_map_entry_access>              iterator;
+        typedef detail::indexed_iterator<const flat_map, const_reference, void, detail::flat_map_entry_access>  const_iterator;
+
+        flat_map() {}
+        explicit flat_map(const Compare& comp) : m_comp(comp) {}
+        // the copy is left empty if allocation fails
+        flat_map(const flat_map& rhs);
+        flat_map& operator=(const flat_map& rhs);
+        flat_map(flat_map&& rhs) = default;
+        flat_map& operator=(flat_map&& rhs) = default;
+
+        // replaces the contents with the pairs of [first, last), which need not be sorted,
+        // for duplicate keys the first pair wins
+        template<class InputIt> bool assign(InputIt first, InputIt last);
+
+        iterator begin() noe_std_no_except { return iterator(this, 0); }
+        const_iterator begin() const noe_std_no_except { return const_iterator(this, 0); }
+        iterator end() noe_std_no_except { return iterator(this, size()); }
+        const_iterator end() const noe_std_no_except { return const_iterator(this, size()); }
+        reference entry(size_type i) { return reference(m_keys[i], m_values[i]); }
+        const_reference entry(size_type i) const { return const_reference(m_keys[i], m_values[i]); }
+        // the two arrays, both size() long and in key order
+        const K* keys() const noe_std_no_except { return m_keys.data(); }
+        V* values() noe_std_no_except { return m_values.data(); }
+        const V* values() const noe_std_no_except { return m_values.data(); }
+
+        size_type size() const noe_std_no_except { return m_keys.size(); }
+        bool empty() const noe_std_no_except { return m_keys.size() == 0; }
+        void reserve(size_type n) { m_keys.reserve(n); m_values.reserve(n); }
+        void shrink_to_fit() { m_keys.shrink_to_fit(); m_values.shrink_to_fit(); }
+        void clear() { m_keys.clear(); m_values.clear(); m_index.clear(); }
+        void swap(flat_map& other) noe_std_no_except;
+        const key_compare& key_comp() const noe_std_no_except { return m_comp; }
+
+        // first is false only if allocation failed, second points to the entry of key;
+        // insert keeps an existing value, insert_or_assign overwrites it, emplace constructs the
+        // value from args only if key is missing. Rvalue arguments may be moved from on failure
+        std::pair<bool, iterator> insert(const K& key, const V& value) { return emplace(key, value); }
+        std::pair<bool, iterator> insert(K&& key, V&& value) { return emplace(std::move(key), std::move(value)); }
+        std::pair<bool, iterator> insert_or_assign(const K& key, const V& value) { return assign_key(key, value); }
+        std::pair<bool, iterator> insert_or_assign(K&& key, V&& value) { return assign_key(std::move(key), std::move(value)); }
+        template<class... Args> std::pair<bool, iterator> emplace(const K& key, Args&&... args) { return emplace_key(key, std::forward<Args>(args)...); }
+        template<class... Args> std::pair<bool, iterator> emplace(K&& key, Args&&... args) { return emplace_key(std::move(key), std::forward<Args>(args)...); }
+        size_type erase(const K& key);
+        iterator erase(const_iterator pos);
+
+        iterator find(const K& key) { return iterator(this, find_index(key)); }
+        const_iterator find(const K& key) const { return const_iterator(this, find_index(key)); }
+        iterator lower_bound(const K& key) { return iterator(this, search(key)); }
+        const_iterator lower_bound(const K& key) const { return const_iterator(this, search(key)); }
+        iterator upper_bound(const K& key) { return iterator(this, upper_index(key)); }
+        const_iterator upper_bound(const K& key) const { return const_iterator(this, upper_index(key)); }
+        bool contains(const K& key) const { return find_index(key) != size(); }
+        size_type count(const K& key) const { return contains(key) ? 1 : 0; }
+        // value of key, 0 if it is not in the map
+        V* get(const K& key);
+        const V* get(const K& key) const;
+
+        // Eytzinger layout for lookups, false if allocation failed (lookups then stay on the sorted keys)
+        bool build_index() { return m_index.build(m_keys.data(), m_keys.size()); }
+        bool has_index() const noe_std_no_except { return m_index.size() != 0; }
+
+    private:
+        typedef typename KeyAllocatorT::template rebind<size_type>::other order_allocator_t;
+
+        size_type search(const K& key) const;
+        size_type find_index(const K& key) const;
+        size_type upper_index(const K& key) const;
+        template<class KeyT, class... Args> std::pair<bool, iterator> emplace_key(KeyT&& key, Args&&... args);
+        template<class KeyT, class ValueT> std::pair<bool, iterator> assign_key(KeyT&& key, ValueT&& value);
+        template<class KeyT, class... Args> std::pair<bool, iterator> insert_at(size_type i, KeyT&& key, Args&&... args);
+
+        vector<K, KeyAllocatorT> m_keys;
+        vector<V, ValueAllocatorT> m_values;
+        detail::eytzinger_index<K, KeyAllocatorT> m_index;
+        Compare m_comp;
+    };
+
+    template<class K, class V, class Compare, class KeyAllocatorT, class ValueAllocatorT>
+    template<class InputIt>
+    bool flat_map<K, V, Compare, KeyAllocatorT, ValueAllocatorT>::assign(InputIt first, InputIt last)
+    {
+        vector<K, KeyAllocatorT> keys;
+        vector<V, ValueAllocatorT> values;
+        for(; first != last; ++first) {
+            if(!keys.push_back(first->first) || !values.push_back(first->second))
+                return false;
+        }
+        // sort a permutation so every key and value is moved exactly once, into its final place
+        size_type n = keys.size();
+        vector<size_type, order_allocator_t> order;
+        if(!order.resize_default_init(n))
+            return false;
+        for(size_type i = 0; i < n; ++i)
+            order[i] = i;
+        const Compare& comp = m_comp;
+        std::stable_sort(order.data(), order.data() + n, [&keys, &comp](size_type a, size_type b) { return comp(keys[a], keys[b]); });
+        size_type* order_end = std::unique(order.data(), order.data() + n, [&keys, &comp](size_type a, size_type b) { return !comp(keys[a], keys[b]); });
+        vector<K, KeyAllocatorT> sorted_keys;
+        vector<V, ValueAllocatorT> sorted_values;
+        for(const size_type* it = order.data(); it != order_end; ++it) {
+            if(!sorted_keys.push_back(std::move(keys[*it])) || !sorted_values.push_back(std::move(values[*it])))
+                return false;
+        }
+        m_keys.swap(sorted_keys);
+        m_values.swap(sorted_values);
+        m_index.clear();
+        return true;
+    }
+
+    template<class K, class V, class Compare, class KeyAllocatorT, class ValueAllocatorT>
+    flat_map<K, V, Compare, KeyAllocatorT, ValueAllocatorT>::flat_map(const flat_map& rhs) :
+        m_keys(rhs.m_keys), m_values(rhs.m_values), m_index(rhs.m_index), m_comp(rhs.m_comp)
+    {
+        // each vector comes back empty if its allocation failed, the keys and values must stay paired
+        if(m_keys.size() != rhs.size() || m_values.size() != rhs.size())
+            clear();
+    }
+
+    template<class K, class V, class Compare, class KeyAllocatorT, class ValueAllocatorT>
+    flat_map<K, V, Compare, KeyAllocatorT, ValueAllocatorT>& flat_map<K, V, Compare, KeyAllocatorT, ValueAllocatorT>::operator=(const flat_map& rhs)
+    {
+        flat_map tmp(rhs);
+        swap(tmp);
+        return *this;
+    }
+
+    template<class K, class V, class Compare, class KeyAllocatorT, class ValueAllocatorT>
+    void flat_map<K, V, Compare, KeyAllocatorT, ValueAllocatorT>::swap(flat_map& other) noe_std_no_except
+    {
+        m_keys.swap(other.m_keys);
+        m_values.swap(other.m_values);
+        m_index.swap(other.m_index);
+        std::swap(m_comp, other.m_comp);
+    }
+
+    template<class K, class V, class Compare, class KeyAllocatorT, class ValueAllocatorT>
+    template<class KeyT, class... Args>
+    std::pair<bool, typename flat_map<K, V, Compare, KeyAllocatorT, ValueAllocatorT>::iterator>
+    flat_map<K, V, Compare, KeyAllocatorT, ValueAllocatorT>::emplace_key(KeyT&& key, Args&&... args)
+    {
+        size_type i = search(key);
+        if(i != size() && !m_comp(key, m_keys[i]))
+            return std::make_pair(true, iterator(this, i));
+        return insert_at(i, std::forward<KeyT>(key), std::forward<Args>(args)...);
+    }
+
+    template<class K, class V, class Compare, class KeyAllocatorT, class ValueAllocatorT>
+    template<class KeyT, class ValueT>
+    std::pair<bool, typename flat_map<K, V, Compare, KeyAllocatorT, ValueAllocatorT>::iterator>
+    flat_map<K, V, Compare, KeyAllocatorT, ValueAllocatorT>::assign_key(KeyT&& key, ValueT&& value)
+    {
+        size_type i = search(key);
+        if(i != size() && !m_comp(key, m_keys[i])) {
+            m_values[i] = std::forward<ValueT>(value);
+            return std::make_pair(true, iterator(this, i));
+        }
+        return insert_at(i, std::forward<KeyT>(key), std::forward<ValueT>(value));
+    }
+
+    template<class K, class V, class Compare, class KeyAllocatorT, class ValueAllocatorT>
+    typename flat_map<K, V, Compare, KeyAllocatorT, ValueAllocatorT>::size_type
+    flat_map<K, V, Compare, KeyAllocatorT, ValueAllocatorT>::erase(const K& key)
+    {
+        size_type i = find_index(key);
+        if(i == size())
+            return 0;
+        erase(const_iterator(this, i));
+        return 1;
+    }
+
+    template<class K, class V, class Compare, class KeyAllocatorT, class ValueAllocatorT>
+    typename flat_map<K, V, Compare, KeyAllocatorT, ValueAllocatorT>::iterator
+    flat_map<K, V, Compare, KeyAllocatorT, ValueAllocatorT>::erase(const_iterator pos)
+    {
+        size_type i = pos.index();
+        m_keys.erase(m_keys.begin() + i);
+        m_values.erase(m_values.begin() + i);
+        m_index.clear();
+        return iterator(this, i);
+    }
+
+    template<class K, class V, class Compare, class KeyAllocatorT, class ValueAllocatorT>
+    V* flat_map<K, V, Compare, KeyAllocatorT, ValueAllocatorT>::get(const K& key)
+    {
+        size_type i = find_index(key);
+        return i != size() ? m_values.data() + i : 0;
+    }
+
+    template<class K, class V, class Compare, class KeyAllocatorT, class ValueAllocatorT>
+    const V* flat_map<K, V, Compare, KeyAllocatorT, ValueAllocatorT>::get(const K& key) const
+    {
+        size_type i = find_index(key);
+        return i != size() ? m_values.data() + i : 0;
+    }
+
+    template<class K, class V, class Compare, class KeyAllocatorT, class ValueAllocatorT>
+    inline typename flat_map<K, V, Compare, KeyAllocatorT, ValueAllocatorT>::size_type
+    flat_map<K, V, Compare, KeyAllocatorT, ValueAllocatorT>::search(const K& key) const
+    {
+        if(m_index.size())
+            return m_index.lower_bound(key, m_comp);
+        return detail::branchless_lower_bound(m_keys.data(), m_keys.size(), key, m_comp);
+    }
+
+    template<class K, class V, class Compare, class KeyAllocatorT, class ValueAllocatorT>
+    inline typename flat_map<K, V, Compare, KeyAllocatorT, ValueAllocatorT>::size_type
+    flat_map<K, V, Compare, KeyAllocatorT, ValueAllocatorT>::find_index(const K& key) const
+    {
+        size_type i = search(key);
+        return (i != size() && !m_comp(key, m_keys[i])) ? i : size();
+    }
+
+    template<class K, class V, class Compare, class KeyAllocatorT, class ValueAllocatorT>
+    inline typename flat_map<K, V, Compare, KeyAllocatorT, ValueAllocatorT>::size_type
+    flat_map<K, V, Compare, KeyAllocatorT, ValueAllocatorT>::upper_index(const K& key) const
+    {
+        size_type i = search(key);
+        return (i != size() && !m_comp(key, m_keys[i])) ? i + 1 : i;
+    }
+
+    template<class K, class V, class Compare, class KeyAllocatorT, class ValueAllocatorT>
+    template<class KeyT, class... Args>
+    std::pair<bool, typename flat_map<K, V, Compare, KeyAllocatorT, ValueAllocatorT>::iterator>
+    flat_map<K, V, Compare, KeyAllocatorT, ValueAllocatorT>::insert_at(size_type i, KeyT&& key, Args&&... args)
+    {
+        // vector::emplace shifts with one memmove for relocatable types, the key goes back out if the value can not follow
+        if(!m_keys.emplace(m_keys.begin() + i, std::forward<KeyT>(key)))
+            return std::make_pair(false, end());
+        if(!m_values.emplace(m_values.begin() + i, std::forward<Args>(args)...)) {
+            m_keys.erase(m_keys.begin() + i);
+            return std::make_pair(false, end());
+        }
+        m_index.clear();
+        return std::make_pair(true, iterator(this, i));
+    }
+}
+
+#endif // GUARD_NOE_STD_flat_map_H
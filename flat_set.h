@@ -0,0 +1,224 @@
+/**
+ * NoException Standard Library Container Implementation
+ * by Marvin Manese 2017
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+#ifndef GUARD_NOE_STD_flat_set_H
+#define GUARD_NOE_STD_flat_set_H
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include "allocator.h"
+#include "macro.h"
+#include "simd_algorithm.h"
+#include "vector.h"
+#include "detail/flat_search.h"
+
+namespace noe_std
+{
+namespace detail
+{
+    /// Sorts [data, data + n) and drops every key equivalent to the one before it (the first one is kept),
+    /// returns the number of keys left
+    template<class K, class Compare>
+    std::size_t flat_sort_unique(K* data, std::size_t n, const Compare& comp)
+    {
+        std::stable_sort(data, data + n, comp);
+        K* last = std::unique(data, data + n, [&comp](const K& a, const K& b) { return !comp(a, b); });
+        return static_cast<std::size_t>(last - data);
+    }
+}
+    /// Set of unique keys kept sorted in one noe_std::vector, lookups are a branchless binary search
+    /// over contiguous memory instead of a walk through tree nodes. Inserting or erasing shifts the tail,
+    /// so it is meant for read mostly tables: build it in bulk with assign and look it up many times.
+    /// build_index adds an Eytzinger copy of the keys for very large tables, any modification drops it.
+    /// Insertions return false (and leave the set untouched) if allocation fails.
+    template<class K,
+             class Compare = std::less<K>,
+             class AllocatorT = allocator<K> >
+    class flat_set
+    {
+    public:
+        typedef K                           key_type;
+        typedef K                           value_type;
+        typedef Compare                     key_compare;
+        typedef AllocatorT                  allocator_type;
+        typedef std::size_t                 size_type;
+        typedef const K&                    const_reference;
+        typedef const K*                    const_pointer;
+        typedef const K*                    const_iterator;
+        typedef const_iterator              iterator;   // keys can not be changed in place
+
+        flat_set() {}
+        explicit flat_set(const Compare& comp) : m_comp(comp) {}
+        // the copy is left empty if allocation fails
+        flat_set(const flat_set& rhs);
+        flat_set& operator=(const flat_set& rhs);
+        flat_set(flat_set&& rhs) = default;
+        flat_set& operator=(flat_set&& rhs) = default;
+
+        // replaces the contents with the unique keys of [first, last), which need not be sorted
+        template<class InputIt> bool assign(InputIt first, InputIt last);
+
+        const_iterator begin() const noe_std_no_except { return m_keys.data(); }
+        const_iterator end() const noe_std_no_except { return m_keys.data() + m_keys.size(); }
+        const_pointer data() const noe_std_no_except { return m_keys.data(); }
+        size_type size() const noe_std_no_except { return m_keys.size(); }
+        bool empty() const noe_std_no_except { return m_keys.size() == 0; }
+        void reserve(size_type n) { m_keys.reserve(n); }
+        void shrink_to_fit() { m_keys.shrink_to_fit(); }
+        void clear() { m_keys.clear(); m_index.clear(); }
+        void swap(flat_set& other) noe_std_no_except;
+        const key_compare& key_comp() const noe_std_no_except { return m_comp; }
+
+        // first is false only if allocation failed, second points to the key (new or already present)
+        std::pair<bool, const_iterator> insert(const K& key) { return insert_key(key); }
+        // key may be moved from on failure
+        std::pair<bool, const_iterator> insert(K&& key) { return insert_key(std::move(key)); }
+        size_type erase(const K& key);
+        const_iterator erase(const_iterator pos);
+
+        const_iterator lower_bound(const K& key) const { return begin() + search(key); }
+        const_iterator upper_bound(const K& key) const;
+        const_iterator find(const K& key) const;
+        bool contains(const K& key) const { return find(key) != end(); }
+        size_type count(const K& key) const { return contains(key) ? 1 : 0; }
+
+        // Eytzinger layout for lookups, false if allocation failed (lookups then stay on the sorted keys)
+        bool build_index() { return m_index.build(m_keys.data(), m_keys.size()); }
+        bool has_index() const noe_std_no_except { return m_index.size() != 0; }
+
+        friend bool operator==(const flat_set& lhs, const flat_set& rhs)
+        {
+            return lhs.size() == rhs.size() &&
+                   detail::contiguous_equal(lhs.data(), rhs.data(), lhs.size(), std::integral_constant<bool, simd::is_vectorizable<K>::value>());
+        }
+        friend bool operator!=(const flat_set& lhs, const flat_set& rhs) { return !(lhs == rhs); }
+
+    private:
+        size_type search(const K& key) const;
+        template<class KeyT> std::pair<bool, const_iterator> insert_key(KeyT&& key);
+
+        vector<K, AllocatorT> m_keys;
+        detail::eytzinger_index<K, AllocatorT> m_index;
+        Compare m_comp;
+    };
+
+    template<class K, class Compare, class AllocatorT>
+    template<class InputIt>
+    bool flat_set<K, Compare, AllocatorT>::assign(InputIt first, InputIt last)
+    {
+        vector<K, AllocatorT> keys;
+        for(; first != last; ++first) {
+            if(!keys.push_back(*first))
+                return false;
+        }
+        keys.resize_default_init(detail::flat_sort_unique(keys.data(), keys.size(), m_comp));
+        m_keys.swap(keys);
+        m_index.clear();
+        return true;
+    }
+
+    template<class K, class Compare, class AllocatorT>
+    flat_set<K, Compare, AllocatorT>::flat_set(const flat_set& rhs) :
+        m_keys(rhs.m_keys), m_index(rhs.m_index), m_comp(rhs.m_comp)
+    {
+        // the keys come back empty if their allocation failed, the index must not outlive them
+        if(m_keys.size() != rhs.size())
+            clear();
+    }
+
+    template<class K, class Compare, class AllocatorT>
+    flat_set<K, Compare, AllocatorT>& flat_set<K, Compare, AllocatorT>::operator=(const flat_set& rhs)
+    {
+        flat_set tmp(rhs);
+        swap(tmp);
+        return *this;
+    }
+
+    template<class K, class Compare, class AllocatorT>
+    void flat_set<K, Compare, AllocatorT>::swap(flat_set& other) noe_std_no_except
+    {
+        m_keys.swap(other.m_keys);
+        m_index.swap(other.m_index);
+        std::swap(m_comp, other.m_comp);
+    }
+
+    template<class K, class Compare, class AllocatorT>
+    template<class KeyT>
+    std::pair<bool, typename flat_set<K, Compare, AllocatorT>::const_iterator> flat_set<K, Compare, AllocatorT>::insert_key(KeyT&& key)
+    {
+        size_type i = search(key);
+        if(i != m_keys.size() && !m_comp(key, m_keys[i]))
+            return std::make_pair(true, begin() + i);
+        if(!m_keys.emplace(m_keys.begin() + i, std::forward<KeyT>(key)))
+            return std::make_pair(false, end());
+        m_index.clear();
+        return std::make_pair(true, begin() + i);
+    }
+
+    template<class K, class Compare, class AllocatorT>
+    typename flat_set<K, Compare, AllocatorT>::size_type flat_set<K, Compare, AllocatorT>::erase(const K& key)
+    {
+        const_iterator it = find(key);
+        if(it == end())
+            return 0;
+        erase(it);
+        return 1;
+    }
+
+    template<class K, class Compare, class AllocatorT>
+    typename flat_set<K, Compare, AllocatorT>::const_iterator flat_set<K, Compare, AllocatorT>::erase(const_iterator pos)
+    {
+        size_type i = static_cast<size_type>(pos - begin());
+        m_keys.erase(m_keys.begin() + i);
+        m_index.clear();
+        return begin() + i;
+    }
+
+    template<class K, class Compare, class AllocatorT>
+    typename flat_set<K, Compare, AllocatorT>::const_iterator flat_set<K, Compare, AllocatorT>::upper_bound(const K& key) const
+    {
+        size_type i = search(key);
+        if(i != m_keys.size() && !m_comp(key, m_keys[i]))
+            ++i;
+        return begin() + i;
+    }
+
+    template<class K, class Compare, class AllocatorT>
+    typename flat_set<K, Compare, AllocatorT>::const_iterator flat_set<K, Compare, AllocatorT>::find(const K& key) const
+    {
+        size_type i = search(key);
+        return (i != m_keys.size() && !m_comp(key, m_keys[i])) ? begin() + i : end();
+    }
+
+    template<class K, class Compare, class AllocatorT>
+    inline typename flat_set<K, Compare, AllocatorT>::size_type flat_set<K, Compare, AllocatorT>::search(const K& key) const
+    {
+        if(m_index.size())
+            return m_index.lower_bound(key, m_comp);
+        return detail::branchless_lower_bound(m_keys.data(), m_keys.size(), key, m_comp);
+    }
+}
+
+#endif // GUARD_NOE_STD_flat_set_H
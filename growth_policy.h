@@ -0,0 +1,128 @@
+/**
+ * NoException Standard Library Container Implementation
+ * by Marvin Manese 2017
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+#ifndef GUARD_NOE_STD_growth_policy_H
+#define GUARD_NOE_STD_growth_policy_H
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+
+/// Growth policies decide how many elements a vector allocates room for.
+/// A policy provides two static functions, both returning at least required:
+///  - grow(capacity, required, value_size): new capacity when the current one is exhausted
+///    (push_back, insert, resize)
+///  - fit(required, value_size): capacity for an explicit request (reserve)
+namespace noe_std
+{
+namespace detail
+{
+    inline std::size_t growth_policy_multiply(std::size_t n, std::size_t numerator, std::size_t denominator)
+    {
+        if(n > std::numeric_limits<std::size_t>::max() / numerator)
+            return std::numeric_limits<std::size_t>::max();
+        return n * numerator / denominator;
+    }
+}
+    /// Multiplies the capacity by Numerator / Denominator, the first allocation holds MinBytes worth
+    /// of elements (at least one), so small elements start with a few slots and large ones with one
+    template<std::size_t Numerator,
+             std::size_t Denominator,
+             std::size_t MinBytes = 64>
+    struct factor_growth_policy
+    {
+        static_assert(Numerator > Denominator && Denominator > 0, "factor_growth_policy needs a factor above 1");
+
+        static std::size_t grow(std::size_t capacity, std::size_t required, std::size_t value_size)
+        {
+            const std::size_t min_capacity = std::max<std::size_t>(MinBytes / value_size, 1);
+            return std::max(required, std::max(detail::growth_policy_multiply(capacity, Numerator, Denominator), min_capacity));
+        }
+
+        static std::size_t fit(std::size_t required, std::size_t /*value_size*/) { return required; }
+    };
+
+    typedef factor_growth_policy<2, 1> double_growth_policy;
+    typedef factor_growth_policy<3, 2> one_and_half_growth_policy;
+
+    /// Rounds the capacity picked by BasePolicy so the buffer fills its allocation: buffers up to
+    /// PageSize bytes are rounded to the next power of two (malloc size classes), larger buffers
+    /// to a multiple of PageSize
+    template<class BasePolicy = double_growth_policy,
+             std::size_t PageSize = 4096>
+    struct size_class_growth_policy
+    {
+        static_assert(PageSize > 0 && (PageSize & (PageSize - 1)) == 0, "PageSize must be a power of two");
+
+        static std::size_t grow(std::size_t capacity, std::size_t required, std::size_t value_size)
+        {
+            return round(BasePolicy::grow(capacity, required, value_size), value_size);
+        }
+
+        static std::size_t fit(std::size_t required, std::size_t value_size)
+        {
+            return round(BasePolicy::fit(required, value_size), value_size);
+        }
+
+        static std::size_t round(std::size_t n, std::size_t value_size)
+        {
+            if(n > (std::numeric_limits<std::size_t>::max() - PageSize) / value_size)
+                return n;
+
+            std::size_t bytes = n * value_size;
+            std::size_t rounded;
+            if(bytes <= PageSize) {
+                rounded = 16;
+                while(rounded < bytes)
+                    rounded <<= 1;
+            } else {
+                rounded = (bytes + (PageSize - 1)) & ~(PageSize - 1);
+            }
+            return rounded / value_size;
+        }
+    };
+
+    /// Grows with BasePolicy until the buffer reaches ThresholdBytes, then adds StepBytes at a time
+    /// so very large buffers do not reserve up to half of their size in unused memory
+    template<std::size_t ThresholdBytes = (std::size_t(64) << 20),
+             std::size_t StepBytes = ThresholdBytes,
+             class BasePolicy = double_growth_policy>
+    struct linear_growth_policy
+    {
+        static_assert(StepBytes > 0, "linear_growth_policy needs a positive step");
+
+        static std::size_t grow(std::size_t capacity, std::size_t required, std::size_t value_size)
+        {
+            if(capacity < ThresholdBytes / value_size)
+                return std::min(BasePolicy::grow(capacity, required, value_size), std::max(required, ThresholdBytes / value_size));
+
+            std::size_t step = std::max<std::size_t>(StepBytes / value_size, 1);
+            if(capacity > std::numeric_limits<std::size_t>::max() - step)
+                return required;
+            return std::max(required, capacity + step);
+        }
+
+        static std::size_t fit(std::size_t required, std::size_t value_size) { return BasePolicy::fit(required, value_size); }
+    };
+}
+
+#endif // GUARD_NOE_STD_growth_policy_H
@@ -0,0 +1,516 @@
+/**
+ * NoException Standard Library Container Implementation
+ * by Marvin Manese 2017
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+#ifndef GUARD_NOE_STD_hive_H
+#define GUARD_NOE_STD_hive_H
+
+#include <cstddef>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include "allocator.h"
+#include "macro.h"
+
+namespace noe_std
+{
+    template<class T, class AllocatorT> class hive;
+namespace detail
+{
+    typedef unsigned short hive_skip_t;
+    enum : hive_skip_t { hive_npos = 0xFFFF };
+
+    /// Erased slots hold the links of the free list of erased runs, a run is linked through its first slot
+    struct hive_free_node
+    {
+        hive_skip_t m_prev;
+        hive_skip_t m_next;
+    };
+
+    template<class T>
+    union hive_slot
+    {
+        hive_free_node  m_node;
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type m_value;
+    };
+
+    template<class T>
+    struct hive_block
+    {
+        hive_slot<T>*   m_slots;
+        hive_skip_t*    m_skip;         // capacity + 1 entries, the last one stays 0 to stop iteration
+        hive_skip_t     m_capacity;
+        hive_skip_t     m_high;         // slots ever used, only the last block has unused ones
+        hive_skip_t     m_size;
+        hive_skip_t     m_free_head;    // first slot of the first erased run, hive_npos if none
+        hive_block*     m_prev;
+        hive_block*     m_next;
+        hive_block*     m_prev_free;    // blocks with erased slots
+        hive_block*     m_next_free;
+
+        T* element(hive_skip_t i) { return reinterpret_cast<T*>(&m_slots[i].m_value); }
+    };
+
+    template<class T, class Reference, class Pointer>
+    class hive_iterator
+    {
+    public:
+        typedef std::bidirectional_iterator_tag     iterator_category;
+        typedef T                                   value_type;
+        typedef std::ptrdiff_t                      difference_type;
+        typedef Reference                           reference;
+        typedef Pointer                             pointer;
+
+        hive_iterator() : m_block(0), m_index(0) {}
+        hive_iterator(hive_block<T>* block, hive_skip_t index) : m_block(block), m_index(index) {}
+        // iterator to const_iterator
+        template<class R, class P>
+        hive_iterator(const hive_iterator<T, R, P>& rhs) : m_block(rhs.m_block), m_index(rhs.m_index) {}
+
+        reference operator*() const { return *m_block->element(m_index); }
+        pointer operator->() const { return m_block->element(m_index); }
+
+        hive_iterator& operator++()
+        {
+            // the first slot of an erased run holds the run length, live slots hold 0
+            ++m_index;
+            m_index = static_cast<hive_skip_t>(m_index + m_block->m_skip[m_index]);
+            // the past the end position of the last block is end()
+            if(m_index >= m_block->m_high && m_block->m_next) {
+                m_block = m_block->m_next;
+                m_index = m_block->m_skip[0];
+            }
+            return *this;
+        }
+        hive_iterator operator++(int) { hive_iterator it(*this); ++(*this); return it; }
+        hive_iterator& operator--()
+        {
+            // the last slot of an erased run holds the run length too, blocks are never empty
+            while(true) {
+                if(m_index == 0) {
+                    m_block = m_block->m_prev;
+                    m_index = m_block->m_high;
+                }
+                hive_skip_t skip = m_block->m_skip[m_index - 1];
+                if(skip < m_index) {
+                    m_index = static_cast<hive_skip_t>(m_index - 1 - skip);
+                    return *this;
+                }
+                m_index = 0;
+            }
+        }
+        hive_iterator operator--(int) { hive_iterator it(*this); --(*this); return it; }
+
+        bool operator==(const hive_iterator& rhs) const { return m_block == rhs.m_block && m_index == rhs.m_index; }
+        bool operator!=(const hive_iterator& rhs) const { return !(*this == rhs); }
+
+    private:
+        template<class U, class AllocatorU> friend class noe_std::hive;
+        template<class U, class R, class P> friend class hive_iterator;
+
+        hive_block<T>*  m_block;
+        hive_skip_t     m_index;
+    };
+}
+    /// Bucket container with stable element addresses (a colony). Elements live in blocks that grow
+    /// geometrically up to 8192 slots, insert and erase are O(1) and never move an element, so
+    /// pointers and iterators stay valid until their own element is erased.
+    /// Erased slots are reused through a per block free list before new slots are taken, and
+    /// iteration jumps over runs of erased slots with a skip field, so it streams through memory
+    /// almost like a vector. A block is freed as soon as its last element is erased.
+    /// Iteration order is not insertion order.
+    template<class T,
+             class AllocatorT = allocator<T>>
+    class hive
+    {
+        typedef detail::hive_block<T>   block_t;
+        typedef detail::hive_slot<T>    slot_t;
+        typedef detail::hive_skip_t     skip_t;
+        typedef typename std::allocator_traits<AllocatorT>::template rebind_alloc<block_t>          block_allocator_t;
+        typedef typename std::allocator_traits<AllocatorT>::template rebind_alloc<slot_t>           slot_allocator_t;
+        typedef typename std::allocator_traits<AllocatorT>::template rebind_alloc<skip_t>           skip_allocator_t;
+        enum : std::size_t { min_block_capacity = 8, max_block_capacity = 8192 };
+
+    public:
+        typedef T                   value_type;
+        typedef AllocatorT          allocator_type;
+        typedef std::size_t         size_type;
+        typedef std::ptrdiff_t      difference_type;
+        typedef value_type&         reference;
+        typedef const value_type&   const_reference;
+        typedef value_type*         pointer;
+        typedef const value_type*   const_pointer;
+        typedef detail::hive_iterator<T, T&, T*>                iterator;
+        typedef detail::hive_iterator<T, const T&, const T*>    const_iterator;
+
+        hive() noe_std_no_except : m_first(0), m_last(0), m_first_free(0), m_size(0), m_capacity(0) {}
+        hive(const hive& rhs);
+        hive(hive&& rhs) noe_std_no_except;
+        hive& operator=(const hive& rhs);
+        hive& operator=(hive&& rhs) noe_std_no_except;
+        ~hive() { clear(); }
+
+        iterator begin() { return iterator(m_first, m_first ? m_first->m_skip[0] : skip_t(0)); }
+        const_iterator begin() const { return const_iterator(m_first, m_first ? m_first->m_skip[0] : skip_t(0)); }
+        const_iterator cbegin() const { return begin(); }
+        iterator end() { return m_last ? iterator(m_last, m_last->m_high) : iterator(); }
+        const_iterator end() const { return m_last ? const_iterator(m_last, m_last->m_high) : const_iterator(); }
+        const_iterator cend() const { return end(); }
+
+        bool empty() const noe_std_no_except { return (m_size == 0); }
+        size_type size() const noe_std_no_except { return m_size; }
+        size_type capacity() const noe_std_no_except { return m_capacity; }
+
+        // first is false (and nothing is inserted) if allocation fails
+        std::pair<bool, iterator> insert(const_reference v) { return emplace(v); }
+        std::pair<bool, iterator> insert(value_type&& v) { return emplace(std::move(v)); }
+        template<class... Args> std::pair<bool, iterator> emplace(Args&&... args);
+        /// Returns the iterator following it
+        iterator erase(const_iterator it);
+        /// Finds the element at p, end() if p is not in this hive. O(number of blocks)
+        iterator get_iterator(const_pointer p);
+        void clear();
+        void swap(hive& other) noe_std_no_except;
+
+    private:
+        block_t* allocate_block(size_type capacity);
+        void deallocate_block(block_t* block);
+        void unlink_block(block_t* block);
+        void link_free_block(block_t* block);
+        void unlink_free_block(block_t* block);
+        void push_run(block_t* block, skip_t first);
+        void remove_run(block_t* block, skip_t first);
+        void move_run(block_t* block, skip_t from, skip_t to);
+        skip_t take_slot(block_t* block);
+
+        block_t*    m_first;
+        block_t*    m_last;
+        block_t*    m_first_free;
+        size_type   m_size;
+        size_type   m_capacity;
+    };
+
+    template<class T, class AllocatorT>
+    hive<T, AllocatorT>::hive(const hive& rhs)
+        : m_first(0), m_last(0), m_first_free(0), m_size(0), m_capacity(0)
+    {
+        for(const_iterator it = rhs.begin(), it_end = rhs.end(); it != it_end; ++it) {
+            if(!emplace(*it).first)
+                return;
+        }
+    }
+
+    template<class T, class AllocatorT>
+    hive<T, AllocatorT>::hive(hive&& rhs) noe_std_no_except
+        : m_first(rhs.m_first), m_last(rhs.m_last), m_first_free(rhs.m_first_free), m_size(rhs.m_size), m_capacity(rhs.m_capacity)
+    {
+        rhs.m_first = rhs.m_last = rhs.m_first_free = 0;
+        rhs.m_size = rhs.m_capacity = 0;
+    }
+
+    template<class T, class AllocatorT>
+    hive<T, AllocatorT>& hive<T, AllocatorT>::operator=(const hive& rhs)
+    {
+        if(this != &rhs) {
+            hive copy(rhs);
+            swap(copy);
+        }
+        return *this;
+    }
+
+    template<class T, class AllocatorT>
+    hive<T, AllocatorT>& hive<T, AllocatorT>::operator=(hive&& rhs) noe_std_no_except
+    {
+        if(this != &rhs) {
+            clear();
+            swap(rhs);
+        }
+        return *this;
+    }
+
+    template<class T, class AllocatorT>
+    template<class... Args>
+    std::pair<bool, typename hive<T, AllocatorT>::iterator> hive<T, AllocatorT>::emplace(Args&&... args)
+    {
+        block_t* block;
+        skip_t index;
+        if(m_first_free) {
+            // recycle an erased slot
+            block = m_first_free;
+            index = take_slot(block);
+        }
+        else if(m_last && m_last->m_high < m_last->m_capacity) {
+            block = m_last;
+            index = block->m_high++;
+        }
+        else {
+            // the next block matches the current size, within the block limits
+            size_type capacity = m_size < size_type(min_block_capacity) ? size_type(min_block_capacity) :
+                                 m_size > size_type(max_block_capacity) ? size_type(max_block_capacity) : m_size;
+            block = allocate_block(capacity);
+            if(!block)
+                return std::make_pair(false, end());
+            index = block->m_high++;
+        }
+        ::new(static_cast<void*>(block->element(index))) T(std::forward<Args>(args)...);
+        ++block->m_size;
+        ++m_size;
+        return std::make_pair(true, iterator(block, index));
+    }
+
+    template<class T, class AllocatorT>
+    typename hive<T, AllocatorT>::iterator hive<T, AllocatorT>::erase(const_iterator it)
+    {
+        block_t* block = it.m_block;
+        skip_t i = it.m_index;
+        iterator next(block, i);
+        ++next;
+
+        block->element(i)->~T();
+        --m_size;
+        if(--block->m_size == 0) {
+            // nothing left to skip, drop the whole block
+            deallocate_block(block);
+            return next.m_block == block ? end() : next;
+        }
+
+        skip_t* skip = block->m_skip;
+        const bool left = (i > 0 && skip[i - 1]);
+        const bool right = (i + 1 < block->m_high && skip[i + 1]);
+        if(!left && !right) {
+            skip[i] = 1;
+            push_run(block, i);
+        }
+        else if(left && !right) {
+            skip_t length = static_cast<skip_t>(skip[i - 1] + 1);
+            skip[i - length + 1] = length;
+            skip[i] = length;
+        }
+        else if(!left && right) {
+            skip_t length = static_cast<skip_t>(skip[i + 1] + 1);
+            move_run(block, static_cast<skip_t>(i + 1), i);
+            skip[i] = length;
+            skip[i + length - 1] = length;
+        }
+        else {
+            skip_t left_length = skip[i - 1];
+            skip_t right_length = skip[i + 1];
+            skip_t length = static_cast<skip_t>(left_length + 1 + right_length);
+            remove_run(block, static_cast<skip_t>(i + 1));
+            skip[i - left_length] = length;
+            skip[i + right_length] = length;
+            // interior nodes are never read, but keep them non zero for the neighbour checks above
+            skip[i] = length;
+        }
+        return next;
+    }
+
+    template<class T, class AllocatorT>
+    typename hive<T, AllocatorT>::iterator hive<T, AllocatorT>::get_iterator(const_pointer p)
+    {
+        for(block_t* block = m_first; block; block = block->m_next) {
+            const T* first = block->element(0);
+            if(p >= first && p < first + block->m_high) {
+                skip_t index = static_cast<skip_t>(p - first);
+                return block->m_skip[index] ? end() : iterator(block, index);
+            }
+        }
+        return end();
+    }
+
+    template<class T, class AllocatorT>
+    void hive<T, AllocatorT>::clear()
+    {
+        while(m_first) {
+            block_t* block = m_first;
+            if(!std::is_trivially_destructible<T>::value) {
+                for(skip_t i = block->m_skip[0]; i < block->m_high; ++i, i = static_cast<skip_t>(i + block->m_skip[i]))
+                    block->element(i)->~T();
+            }
+            m_size -= block->m_size;
+            block->m_size = 0;
+            deallocate_block(block);
+        }
+    }
+
+    template<class T, class AllocatorT>
+    void hive<T, AllocatorT>::swap(hive& other) noe_std_no_except
+    {
+        std::swap(m_first, other.m_first);
+        std::swap(m_last, other.m_last);
+        std::swap(m_first_free, other.m_first_free);
+        std::swap(m_size, other.m_size);
+        std::swap(m_capacity, other.m_capacity);
+    }
+
+    template<class T, class AllocatorT>
+    typename hive<T, AllocatorT>::block_t* hive<T, AllocatorT>::allocate_block(size_type capacity)
+    {
+        block_allocator_t block_alloc;
+        slot_allocator_t slot_alloc;
+        skip_allocator_t skip_alloc;
+        block_t* block = block_alloc.allocate(1);
+        if(!block)
+            return 0;
+        block->m_slots = slot_alloc.allocate(capacity);
+        block->m_skip = skip_alloc.allocate(capacity + 1);
+        if(!block->m_slots || !block->m_skip) {
+            if(block->m_slots)
+                slot_alloc.deallocate(block->m_slots, capacity);
+            if(block->m_skip)
+                skip_alloc.deallocate(block->m_skip, capacity + 1);
+            block_alloc.deallocate(block, 1);
+            return 0;
+        }
+        for(size_type i = 0; i <= capacity; ++i)
+            block->m_skip[i] = 0;
+        block->m_capacity = static_cast<skip_t>(capacity);
+        block->m_high = 0;
+        block->m_size = 0;
+        block->m_free_head = detail::hive_npos;
+        block->m_prev = m_last;
+        block->m_next = 0;
+        block->m_prev_free = block->m_next_free = 0;
+        if(m_last)
+            m_last->m_next = block;
+        else
+            m_first = block;
+        m_last = block;
+        m_capacity += capacity;
+        return block;
+    }
+
+    template<class T, class AllocatorT>
+    void hive<T, AllocatorT>::deallocate_block(block_t* block)
+    {
+        unlink_block(block);
+        if(block->m_free_head != detail::hive_npos)
+            unlink_free_block(block);
+        m_capacity -= block->m_capacity;
+        slot_allocator_t().deallocate(block->m_slots, block->m_capacity);
+        skip_allocator_t().deallocate(block->m_skip, block->m_capacity + 1);
+        block_allocator_t().deallocate(block, 1);
+    }
+
+    template<class T, class AllocatorT>
+    void hive<T, AllocatorT>::unlink_block(block_t* block)
+    {
+        if(block->m_prev)
+            block->m_prev->m_next = block->m_next;
+        else
+            m_first = block->m_next;
+        if(block->m_next)
+            block->m_next->m_prev = block->m_prev;
+        else
+            m_last = block->m_prev;
+    }
+
+    template<class T, class AllocatorT>
+    void hive<T, AllocatorT>::link_free_block(block_t* block)
+    {
+        block->m_prev_free = 0;
+        block->m_next_free = m_first_free;
+        if(m_first_free)
+            m_first_free->m_prev_free = block;
+        m_first_free = block;
+    }
+
+    template<class T, class AllocatorT>
+    void hive<T, AllocatorT>::unlink_free_block(block_t* block)
+    {
+        if(block->m_prev_free)
+            block->m_prev_free->m_next_free = block->m_next_free;
+        else
+            m_first_free = block->m_next_free;
+        if(block->m_next_free)
+            block->m_next_free->m_prev_free = block->m_prev_free;
+    }
+
+    template<class T, class AllocatorT>
+    void hive<T, AllocatorT>::push_run(block_t* block, skip_t first)
+    {
+        if(block->m_free_head == detail::hive_npos)
+            link_free_block(block);
+        else
+            block->m_slots[block->m_free_head].m_node.m_prev = first;
+        block->m_slots[first].m_node.m_prev = detail::hive_npos;
+        block->m_slots[first].m_node.m_next = block->m_free_head;
+        block->m_free_head = first;
+    }
+
+    template<class T, class AllocatorT>
+    void hive<T, AllocatorT>::remove_run(block_t* block, skip_t first)
+    {
+        detail::hive_free_node node = block->m_slots[first].m_node;
+        if(node.m_prev != detail::hive_npos)
+            block->m_slots[node.m_prev].m_node.m_next = node.m_next;
+        else
+            block->m_free_head = node.m_next;
+        if(node.m_next != detail::hive_npos)
+            block->m_slots[node.m_next].m_node.m_prev = node.m_prev;
+        if(block->m_free_head == detail::hive_npos)
+            unlink_free_block(block);
+    }
+
+    template<class T, class AllocatorT>
+    void hive<T, AllocatorT>::move_run(block_t* block, skip_t from, skip_t to)
+    {
+        // the run now starts at to, its list node moves along
+        detail::hive_free_node node = block->m_slots[from].m_node;
+        block->m_slots[to].m_node = node;
+        if(node.m_prev != detail::hive_npos)
+            block->m_slots[node.m_prev].m_node.m_next = to;
+        else
+            block->m_free_head = to;
+        if(node.m_next != detail::hive_npos)
+            block->m_slots[node.m_next].m_node.m_prev = to;
+    }
+
+    template<class T, class AllocatorT>
+    typename hive<T, AllocatorT>::skip_t hive<T, AllocatorT>::take_slot(block_t* block)
+    {
+        // reuse the first slot of the first run, the rest of the run shifts by one
+        skip_t first = block->m_free_head;
+        skip_t* skip = block->m_skip;
+        skip_t length = skip[first];
+        if(length == 1) {
+            remove_run(block, first);
+        }
+        else {
+            move_run(block, first, static_cast<skip_t>(first + 1));
+            skip[first + 1] = static_cast<skip_t>(length - 1);
+            skip[first + length - 1] = static_cast<skip_t>(length - 1);
+        }
+        skip[first] = 0;
+        return first;
+    }
+}
+namespace std
+{
+    template<class T, class AllocatorT>
+    inline void swap(noe_std::hive<T, AllocatorT>& h1, noe_std::hive<T, AllocatorT>& h2) noe_std_no_except
+    {
+        h1.swap(h2);
+    }
+}
+
+#endif // GUARD_NOE_STD_hive_H
@@ -0,0 +1,296 @@
+/**
+ * NoException Standard Library Container Implementation
+ * by Marvin Manese 2017
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+#ifndef GUARD_NOE_STD_huge_page_allocator_H
+#define GUARD_NOE_STD_huge_page_allocator_H
+
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include "allocator.h"
+#include "macro.h"
+
+#if defined(__linux__) && !defined(NOE_STD_NO_MMAP)
+#define NOE_STD_HUGE_PAGE_MMAP
+#include <sys/mman.h>
+#include <unistd.h>
+#endif // defined(__linux__)
+
+namespace noe_std
+{
+    /// Transparent huge page size on x86-64 and 4K granule AArch64
+    enum : std::size_t { huge_page_size = std::size_t(2) * 1024 * 1024 };
+namespace detail
+{
+#ifdef NOE_STD_HUGE_PAGE_MMAP
+    inline std::size_t system_page_size() noe_std_no_except
+    {
+        static const std::size_t size = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+        return size;
+    }
+
+    /// Mapping length for bytes, whole huge pages once the block is that big, whole pages below
+    inline std::size_t huge_page_mapping_bytes(std::size_t bytes) noe_std_no_except
+    {
+        std::size_t unit = bytes >= huge_page_size ? std::size_t(huge_page_size) : system_page_size();
+        return (bytes + unit - 1) & ~(unit - 1);
+    }
+
+    /// Asks for transparent huge pages, a kernel with THP disabled just keeps small pages
+    inline void huge_page_advise(void* p, std::size_t bytes) noe_std_no_except
+    {
+#ifdef MADV_HUGEPAGE
+        if(bytes >= huge_page_size)
+            ::madvise(p, bytes, MADV_HUGEPAGE);
+#else
+        (void)p;
+        (void)bytes;
+#endif // MADV_HUGEPAGE
+    }
+
+    /// Takes the first touch page faults now instead of on the first write
+    inline void huge_page_prefault(void* p, std::size_t bytes) noe_std_no_except
+    {
+#ifdef MADV_POPULATE_WRITE
+        if(::madvise(p, bytes, MADV_POPULATE_WRITE) == 0)
+            return;
+#endif // MADV_POPULATE_WRITE
+        volatile unsigned char* bytes_p = static_cast<unsigned char*>(p);
+        for(std::size_t i = 0; i < bytes; i += system_page_size())
+            bytes_p[i] = 0;
+    }
+
+    /// Anonymous mapping of length bytes, huge page aligned when it spans huge pages, 0 on failure
+    inline void* huge_page_map(std::size_t length) noe_std_no_except
+    {
+        std::size_t slack = length >= huge_page_size ? std::size_t(huge_page_size) : 0;
+        void* p = ::mmap(0, length + slack, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if(p == MAP_FAILED)
+            return 0;
+        if(slack) {
+            // trim the over mapping down to an aligned window
+            unsigned char* begin = static_cast<unsigned char*>(p);
+            unsigned char* aligned = reinterpret_cast<unsigned char*>((reinterpret_cast<std::size_t>(begin) + slack - 1) & ~(slack - 1));
+            if(aligned != begin)
+                ::munmap(begin, aligned - begin);
+            if(std::size_t tail = slack - (aligned - begin))
+                ::munmap(aligned + length, tail);
+            p = aligned;
+        }
+        huge_page_advise(p, length);
+        return p;
+    }
+#endif // NOE_STD_HUGE_PAGE_MMAP
+}
+    /// Allocator for very large buffers. Blocks of at least Threshold bytes are mapped directly
+    /// with mmap, aligned to and advised for transparent huge pages, smaller ones come from
+    /// allocator<T>. With Prefault the pages of a new mapping are faulted in by allocate so
+    /// first touch faults stay off the latency sensitive path.
+    /// Mapped blocks grow, shrink and move with mremap, so vector never copies them
+    /// (see detail::allocator_extensions). Like every noe_std allocator, failure returns 0.
+    /// Without mremap (anything but Linux, or with NOE_STD_NO_MMAP defined) every block comes from allocator<T>.
+    template<class T, std::size_t Threshold = huge_page_size, bool Prefault = false>
+    class huge_page_allocator
+    {
+    public:
+        typedef T                   value_type;
+        typedef value_type*         pointer;
+        typedef const pointer       const_pointer;
+        typedef value_type&         reference;
+        typedef const reference     const_reference;
+        typedef std::size_t       size_type;
+        typedef std::ptrdiff_t    difference_type;
+
+        template<class U>
+        struct rebind
+        {
+            typedef huge_page_allocator<U, Threshold, Prefault> other;
+        };
+
+        huge_page_allocator() noe_std_no_except {}
+        ~huge_page_allocator() noe_std_no_except {}
+
+        pointer allocate(size_type n) noe_std_no_except;
+        void deallocate(pointer p, size_type n) noe_std_no_except;
+        allocation_result<pointer, size_type> allocate_at_least(size_type n) noe_std_no_except;
+        bool try_expand(pointer p, size_type old_n, size_type new_n) noe_std_no_except;
+        bool shrink_in_place(pointer p, size_type old_n, size_type new_n) noe_std_no_except;
+        pointer reallocate(pointer p, size_type old_n, size_type new_n) noe_std_no_except;
+        constexpr size_type max_size() const noexcept { return detail::allocator_max_size<T, huge_page_size>::value; }
+        template<class... Args> void construct(pointer p, Args&&... args) { new(p) T(std::forward<Args>(args)...); }
+        void destroy(pointer p) { p->~T(); }
+
+    private:
+        typedef allocator<T> small_allocator_t;
+
+        // a block is mapped exactly when its element count reaches the threshold, the counts
+        // reported back never cross it, so deallocate can tell the two kinds apart from n alone
+        static bool is_mapped(size_type n) noe_std_no_except
+        {
+#ifdef NOE_STD_HUGE_PAGE_MMAP
+            return n * sizeof(T) >= Threshold;
+#else
+            (void)n;
+            return false;
+#endif // NOE_STD_HUGE_PAGE_MMAP
+        }
+
+        static size_type small_limit() noe_std_no_except { return Threshold ? (Threshold - 1) / sizeof(T) : 0; }
+        pointer move_block(pointer p, size_type old_n, size_type new_n) noe_std_no_except;
+    };
+
+    template<class T, std::size_t Threshold, bool Prefault>
+    typename huge_page_allocator<T, Threshold, Prefault>::pointer huge_page_allocator<T, Threshold, Prefault>::allocate(size_type n) noe_std_no_except
+    {
+        if(n > max_size())
+            return 0;
+        if(!is_mapped(n))
+            return small_allocator_t().allocate(n);
+#ifdef NOE_STD_HUGE_PAGE_MMAP
+        std::size_t length = detail::huge_page_mapping_bytes(n * sizeof(T));
+        void* p = detail::huge_page_map(length);
+        if(p && Prefault)
+            detail::huge_page_prefault(p, length);
+        return static_cast<pointer>(p);
+#else
+        return 0;
+#endif // NOE_STD_HUGE_PAGE_MMAP
+    }
+
+    template<class T, std::size_t Threshold, bool Prefault>
+    void huge_page_allocator<T, Threshold, Prefault>::deallocate(pointer p, size_type n) noe_std_no_except
+    {
+        if(!p)
+            return;
+        if(!is_mapped(n)) {
+            small_allocator_t().deallocate(p, n);
+            return;
+        }
+#ifdef NOE_STD_HUGE_PAGE_MMAP
+        ::munmap(p, detail::huge_page_mapping_bytes(n * sizeof(T)));
+#endif // NOE_STD_HUGE_PAGE_MMAP
+    }
+
+    template<class T, std::size_t Threshold, bool Prefault>
+    allocation_result<typename huge_page_allocator<T, Threshold, Prefault>::pointer, typename huge_page_allocator<T, Threshold, Prefault>::size_type> huge_page_allocator<T, Threshold, Prefault>::allocate_at_least(size_type n) noe_std_no_except
+    {
+        allocation_result<pointer, size_type> result;
+        if(!is_mapped(n)) {
+            result = small_allocator_t().allocate_at_least(n);
+            // malloc slack must not push the count over the threshold
+            if(result.ptr && is_mapped(result.count))
+                result.count = small_limit();
+            return result;
+        }
+        result.ptr = allocate(n);
+#ifdef NOE_STD_HUGE_PAGE_MMAP
+        result.count = result.ptr ? detail::huge_page_mapping_bytes(n * sizeof(T)) / sizeof(T) : 0;
+#else
+        result.count = 0;
+#endif // NOE_STD_HUGE_PAGE_MMAP
+        return result;
+    }
+
+    template<class T, std::size_t Threshold, bool Prefault>
+    bool huge_page_allocator<T, Threshold, Prefault>::try_expand(pointer p, size_type old_n, size_type new_n) noe_std_no_except
+    {
+        if(new_n > max_size())
+            return false;
+        if(!is_mapped(old_n))
+            return !is_mapped(new_n) && small_allocator_t().try_expand(p, old_n, new_n);
+#ifdef NOE_STD_HUGE_PAGE_MMAP
+        std::size_t old_length = detail::huge_page_mapping_bytes(old_n * sizeof(T));
+        std::size_t new_length = detail::huge_page_mapping_bytes(new_n * sizeof(T));
+        if(new_length <= old_length)
+            return true;
+        // without MREMAP_MAYMOVE the kernel only extends the mapping if the pages after it are free
+        if(::mremap(p, old_length, new_length, 0) == MAP_FAILED)
+            return false;
+        detail::huge_page_advise(p, new_length);
+        if(Prefault)
+            detail::huge_page_prefault(reinterpret_cast<unsigned char*>(p) + old_length, new_length - old_length);
+        return true;
+#else
+        return false;
+#endif // NOE_STD_HUGE_PAGE_MMAP
+    }
+
+    template<class T, std::size_t Threshold, bool Prefault>
+    bool huge_page_allocator<T, Threshold, Prefault>::shrink_in_place(pointer p, size_type old_n, size_type new_n) noe_std_no_except
+    {
+        // malloc blocks can not be shrunk in place, mapped ones only while they stay mapped
+        if(!is_mapped(old_n) || !is_mapped(new_n))
+            return false;
+#ifdef NOE_STD_HUGE_PAGE_MMAP
+        std::size_t old_length = detail::huge_page_mapping_bytes(old_n * sizeof(T));
+        std::size_t new_length = detail::huge_page_mapping_bytes(new_n * sizeof(T));
+        if(new_length < old_length)
+            ::munmap(reinterpret_cast<unsigned char*>(p) + new_length, old_length - new_length);
+        return true;
+#else
+        (void)p;
+        return false;
+#endif // NOE_STD_HUGE_PAGE_MMAP
+    }
+
+    template<class T, std::size_t Threshold, bool Prefault>
+    typename huge_page_allocator<T, Threshold, Prefault>::pointer huge_page_allocator<T, Threshold, Prefault>::reallocate(pointer p, size_type old_n, size_type new_n) noe_std_no_except
+    {
+        if(new_n == 0 || new_n > max_size())
+            return 0;
+        if(is_mapped(old_n) != is_mapped(new_n))
+            return move_block(p, old_n, new_n);
+        if(!is_mapped(new_n))
+            return small_allocator_t().reallocate(p, old_n, new_n);
+#ifdef NOE_STD_HUGE_PAGE_MMAP
+        // page tables are moved, not the bytes
+        std::size_t old_length = detail::huge_page_mapping_bytes(old_n * sizeof(T));
+        std::size_t new_length = detail::huge_page_mapping_bytes(new_n * sizeof(T));
+        void* result = ::mremap(p, old_length, new_length, MREMAP_MAYMOVE);
+        if(result == MAP_FAILED)
+            return 0;
+        detail::huge_page_advise(result, new_length);
+        if(Prefault && new_length > old_length)
+            detail::huge_page_prefault(static_cast<unsigned char*>(result) + old_length, new_length - old_length);
+        return static_cast<pointer>(result);
+#else
+        return 0;
+#endif // NOE_STD_HUGE_PAGE_MMAP
+    }
+
+    template<class T, std::size_t Threshold, bool Prefault>
+    typename huge_page_allocator<T, Threshold, Prefault>::pointer huge_page_allocator<T, Threshold, Prefault>::move_block(pointer p, size_type old_n, size_type new_n) noe_std_no_except
+    {
+        // crossing the threshold changes the kind of block, copy the bytes over
+        pointer result = allocate(new_n);
+        if(!result)
+            return 0;
+        std::memcpy(static_cast<void*>(result), static_cast<const void*>(p), (old_n < new_n ? old_n : new_n) * sizeof(T));
+        deallocate(p, old_n);
+        return result;
+    }
+}
+
+#endif // GUARD_NOE_STD_huge_page_allocator_H
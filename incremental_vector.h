@@ -0,0 +1,320 @@
+/**
+ * NoException Standard Library Container Implementation
+ * by Marvin Manese 2017
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+#ifndef GUARD_NOE_STD_incremental_vector_H
+#define GUARD_NOE_STD_incremental_vector_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include "allocator.h"
+#include "growth_policy.h"
+#include "macro.h"
+#include "type_traits.h"
+#include "detail/indexed_iterator.h"
+
+namespace noe_std
+{
+    /// Vector whose growth never relocates all elements at once: when the buffer is full a larger one
+    /// is allocated and the elements migrate to it a few at a time, piggybacked on the following
+    /// push_backs (or driven explicitly through migrate). Until the migration completes, indices in
+    /// [migrated, old size) are read from the old buffer and everything else from the new one, so
+    /// element access pays one extra compare. The per push step is picked when growing so the
+    /// migration always ends before the new buffer fills up, it is never below MigrateStep and grows
+    /// only for growth factors close to 1 (e.g. linear_growth_policy on huge buffers).
+    /// Elements do not move until they are migrated, so pointers stay valid a bit longer than with
+    /// vector, but the storage is only contiguous (data()) once no migration is pending.
+    /// Like vector, insertions return false (and leave the vector untouched) if allocation fails.
+    template<class T,
+             class AllocatorT = allocator<T>,
+             class GrowthPolicyT = double_growth_policy,
+             std::size_t MigrateStep = 16>
+    class incremental_vector
+    {
+        static_assert(MigrateStep > 0, "incremental_vector needs to migrate at least one element per step");
+
+        typedef std::allocator_traits<AllocatorT>                                   alloc_traits_t;
+        typedef std::integral_constant<bool, is_trivially_relocatable<T>::value>    trivially_relocatable_t;
+
+    public:
+        typedef AllocatorT                                  allocator_type;
+        typedef typename alloc_traits_t::value_type         value_type;
+        typedef typename alloc_traits_t::size_type          size_type;
+        typedef typename alloc_traits_t::difference_type    difference_type;
+        typedef value_type&                                 reference;
+        typedef const value_type&                           const_reference;
+        typedef typename alloc_traits_t::pointer            pointer;
+        typedef typename alloc_traits_t::const_pointer      const_pointer;
+        typedef detail::indexed_iterator<incremental_vector, reference, pointer>                                iterator;
+        typedef detail::indexed_iterator<const incremental_vector, const_reference, const_pointer>              const_iterator;
+
+        incremental_vector() : m_member() {}
+        incremental_vector(const incremental_vector& rhs);
+        incremental_vector& operator=(const incremental_vector& rhs);
+        incremental_vector(incremental_vector&& rhs) noe_std_no_except : m_member() { swap(rhs); }
+        incremental_vector& operator=(incremental_vector&& rhs) noe_std_no_except { swap(rhs); return *this; }
+        ~incremental_vector();
+
+        reference operator[](size_type n) { return *locate(n); }
+        const_reference operator[](size_type n) const { return *locate(n); }
+        reference front() { return (*this)[0]; }
+        const_reference front() const { return (*this)[0]; }
+        reference back() { return (*this)[size() - 1]; }
+        const_reference back() const { return (*this)[size() - 1]; }
+        // contiguous storage, finishes a pending migration first
+        pointer data() { finish_migration(); return m_member.m_data; }
+
+        iterator begin() { return iterator(this, 0); }
+        const_iterator begin() const { return const_iterator(this, 0); }
+        const_iterator cbegin() const { return const_iterator(this, 0); }
+        iterator end() { return iterator(this, size()); }
+        const_iterator end() const { return const_iterator(this, size()); }
+        const_iterator cend() const { return const_iterator(this, size()); }
+
+        bool empty() const noe_std_no_except { return m_member.m_size == 0; }
+        size_type size() const noe_std_no_except { return m_member.m_size; }
+        size_type capacity() const noe_std_no_except { return m_member.m_capacity; }
+        size_type max_size() const noe_std_no_except { return m_member.max_size(); }
+        // starts an incremental migration as well if n exceeds the capacity
+        bool reserve(size_type n);
+        void shrink_to_fit();
+        void clear();
+        void swap(incremental_vector& other) noe_std_no_except { m_member.swap(other.m_member); }
+
+        bool push_back(const_reference v) { return emplace_back(v); }
+        bool push_back(value_type&& v) { return emplace_back(std::move(v)); }
+        template<class... Args> bool emplace_back(Args&&... args);
+        void pop_back();
+
+        // elements still waiting in the old buffer
+        size_type pending() const noe_std_no_except { return m_member.m_old_size - m_member.m_migrated; }
+        bool migrating() const noe_std_no_except { return pending() != 0; }
+        // migrates up to n more elements, e.g. from an idle loop, returns true once none are pending
+        bool migrate(size_type n);
+        void finish_migration() { migrate(pending()); }
+
+    private:
+        pointer locate(size_type n) noe_std_no_except
+        {
+            // a single unsigned compare tells whether n is in [migrated, old size)
+            return size_type(n - m_member.m_migrated) < pending() ? m_member.m_old + n : m_member.m_data + n;
+        }
+        const_pointer locate(size_type n) const noe_std_no_except { return const_cast<incremental_vector*>(this)->locate(n); }
+        size_type next_capacity(size_type required) const { return GrowthPolicyT::grow(m_member.m_capacity, required, sizeof(value_type)); }
+        bool start_growth(size_type new_capacity);
+        void migrate_range(size_type first, size_type n, std::true_type);
+        void migrate_range(size_type first, size_type n, std::false_type);
+        void release_old();
+
+        struct incremental_vector_impl : public allocator_type
+        {
+            incremental_vector_impl() : m_capacity(0), m_size(0), m_data(0), m_old_capacity(0), m_old_size(0), m_migrated(0), m_step(MigrateStep), m_old(0) {}
+
+            void swap(incremental_vector_impl& other) noe_std_no_except
+            {
+                std::swap(m_capacity, other.m_capacity);
+                std::swap(m_size, other.m_size);
+                std::swap(m_data, other.m_data);
+                std::swap(m_old_capacity, other.m_old_capacity);
+                std::swap(m_old_size, other.m_old_size);
+                std::swap(m_migrated, other.m_migrated);
+                std::swap(m_step, other.m_step);
+                std::swap(m_old, other.m_old);
+            }
+
+            size_type   m_capacity;
+            size_type   m_size;
+            pointer     m_data;
+            size_type   m_old_capacity;
+            size_type   m_old_size;     // elements [m_migrated, m_old_size) still live in m_old
+            size_type   m_migrated;
+            size_type   m_step;         // elements migrated per push_back
+            pointer     m_old;
+        } m_member;
+    };
+
+    template<class T, class AllocatorT, class GrowthPolicyT, std::size_t MigrateStep>
+    incremental_vector<T, AllocatorT, GrowthPolicyT, MigrateStep>::incremental_vector(const incremental_vector& rhs) :
+        m_member()
+    {
+        size_type size = rhs.size();
+        if(size && start_growth(size)) { // allocation success / rhs has data?
+            for(size_type i = 0; i < size; ++i)
+                m_member.construct(m_member.m_data + i, rhs[i]);
+            m_member.m_size = size;
+        }
+    }
+
+    template<class T, class AllocatorT, class GrowthPolicyT, std::size_t MigrateStep>
+    incremental_vector<T, AllocatorT, GrowthPolicyT, MigrateStep>& incremental_vector<T, AllocatorT, GrowthPolicyT, MigrateStep>::operator=(const incremental_vector& rhs)
+    {
+        incremental_vector other(rhs);
+        swap(other);
+        return *this;
+    }
+
+    template<class T, class AllocatorT, class GrowthPolicyT, std::size_t MigrateStep>
+    incremental_vector<T, AllocatorT, GrowthPolicyT, MigrateStep>::~incremental_vector()
+    {
+        clear();
+        if(m_member.m_data)
+            m_member.deallocate(m_member.m_data, m_member.m_capacity);
+    }
+
+    template<class T, class AllocatorT, class GrowthPolicyT, std::size_t MigrateStep>
+    bool incremental_vector<T, AllocatorT, GrowthPolicyT, MigrateStep>::reserve(size_type n)
+    {
+        if(n <= capacity())
+            return true;
+        return start_growth(std::max(n, GrowthPolicyT::fit(n, sizeof(value_type))));
+    }
+
+    template<class T, class AllocatorT, class GrowthPolicyT, std::size_t MigrateStep>
+    void incremental_vector<T, AllocatorT, GrowthPolicyT, MigrateStep>::shrink_to_fit()
+    {
+        // an explicit request, so the relocation is done in one go
+        size_type size = m_member.m_size;
+        if(size == capacity())
+            return;
+        if(size > 0 && !start_growth(size))
+            return;
+        finish_migration();
+        if(size == 0 && m_member.m_data) {
+            m_member.deallocate(m_member.m_data, m_member.m_capacity);
+            m_member.m_data = 0;
+            m_member.m_capacity = 0;
+        }
+    }
+
+    template<class T, class AllocatorT, class GrowthPolicyT, std::size_t MigrateStep>
+    void incremental_vector<T, AllocatorT, GrowthPolicyT, MigrateStep>::clear()
+    {
+        while(m_member.m_size)
+            pop_back();
+    }
+
+    template<class T, class AllocatorT, class GrowthPolicyT, std::size_t MigrateStep>
+    template<class... Args>
+    bool incremental_vector<T, AllocatorT, GrowthPolicyT, MigrateStep>::emplace_back(Args&&... args)
+    {
+        size_type size = m_member.m_size;
+        if(size == capacity() && !start_growth(next_capacity(size + 1)))
+            return false;
+        // args may refer to an element of this vector, it stays in place until the step below
+        m_member.construct(m_member.m_data + size, std::forward<Args>(args)...);
+        ++m_member.m_size;
+        if(migrating())
+            migrate(m_member.m_step);
+        return true;
+    }
+
+    template<class T, class AllocatorT, class GrowthPolicyT, std::size_t MigrateStep>
+    void incremental_vector<T, AllocatorT, GrowthPolicyT, MigrateStep>::pop_back()
+    {
+        size_type last = --m_member.m_size;
+        m_member.destroy(locate(last));
+        if(m_member.m_old_size > last) {
+            // the last element was still waiting in the old buffer
+            m_member.m_old_size = last;
+            if(m_member.m_migrated >= last)
+                release_old();
+        }
+    }
+
+    template<class T, class AllocatorT, class GrowthPolicyT, std::size_t MigrateStep>
+    bool incremental_vector<T, AllocatorT, GrowthPolicyT, MigrateStep>::migrate(size_type n)
+    {
+        size_type count = std::min(n, pending());
+        if(count) {
+            migrate_range(m_member.m_migrated, count, trivially_relocatable_t());
+            if(!migrating())
+                release_old();
+        }
+        return !migrating();
+    }
+
+    template<class T, class AllocatorT, class GrowthPolicyT, std::size_t MigrateStep>
+    bool incremental_vector<T, AllocatorT, GrowthPolicyT, MigrateStep>::start_growth(size_type new_capacity)
+    {
+        // only reachable with a migration pending through reserve or shrink_to_fit, the push step
+        // is sized so the previous migration is over before the buffer is full again
+        finish_migration();
+        pointer data = m_member.allocate(new_capacity);
+        if(!data)
+            return false;
+        size_type size = m_member.m_size;
+        if(size == 0) {
+            if(m_member.m_data)
+                m_member.deallocate(m_member.m_data, m_member.m_capacity);
+        } else {
+            m_member.m_old = m_member.m_data;
+            m_member.m_old_capacity = m_member.m_capacity;
+            m_member.m_old_size = size;
+            m_member.m_migrated = 0;
+            // enough per push to be done once the new buffer's free room is used up
+            size_type room = new_capacity > size ? new_capacity - size : 1;
+            m_member.m_step = std::max<size_type>(MigrateStep, (size + room - 1) / room);
+        }
+        m_member.m_data = data;
+        m_member.m_capacity = new_capacity;
+        return true;
+    }
+
+    template<class T, class AllocatorT, class GrowthPolicyT, std::size_t MigrateStep>
+    inline void incremental_vector<T, AllocatorT, GrowthPolicyT, MigrateStep>::migrate_range(size_type first, size_type n, std::true_type)
+    {
+        std::memcpy(static_cast<void*>(m_member.m_data + first), static_cast<const void*>(m_member.m_old + first), n * sizeof(value_type));
+        m_member.m_migrated += n;
+    }
+
+    template<class T, class AllocatorT, class GrowthPolicyT, std::size_t MigrateStep>
+    void incremental_vector<T, AllocatorT, GrowthPolicyT, MigrateStep>::migrate_range(size_type first, size_type n, std::false_type)
+    {
+        for(size_type i = first; i < first + n; ++i) {
+            m_member.construct(m_member.m_data + i, std::move_if_noexcept(m_member.m_old[i]));
+            m_member.destroy(m_member.m_old + i);
+            ++m_member.m_migrated;
+        }
+    }
+
+    template<class T, class AllocatorT, class GrowthPolicyT, std::size_t MigrateStep>
+    void incremental_vector<T, AllocatorT, GrowthPolicyT, MigrateStep>::release_old()
+    {
+        if(m_member.m_old)
+            m_member.deallocate(m_member.m_old, m_member.m_old_capacity);
+        m_member.m_old = 0;
+        m_member.m_old_capacity = 0;
+        m_member.m_old_size = 0;
+        m_member.m_migrated = 0;
+    }
+
+    template<class T, class AllocatorT, class GrowthPolicyT, std::size_t MigrateStep>
+    inline void swap(incremental_vector<T, AllocatorT, GrowthPolicyT, MigrateStep>& v1, incremental_vector<T, AllocatorT, GrowthPolicyT, MigrateStep>& v2) noe_std_no_except
+    {
+        v1.swap(v2);
+    }
+}
+
+#endif // GUARD_NOE_STD_incremental_vector_H
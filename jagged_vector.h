@@ -0,0 +1,247 @@
+/**
+ * NoException Standard Library Container Implementation
+ * by Marvin Manese 2017
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+#ifndef GUARD_NOE_STD_jagged_vector_H
+#define GUARD_NOE_STD_jagged_vector_H
+
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include "allocator.h"
+#include "macro.h"
+#include "vector.h"
+#include "detail/indexed_iterator.h"
+
+namespace noe_std
+{
+    /// Non owning view of one row of a jagged_vector, valid until the next insertion
+    template<class T>
+    class jagged_row
+    {
+    public:
+        typedef T               value_type;
+        typedef std::size_t     size_type;
+        typedef T*              iterator;
+        typedef T*              pointer;
+        typedef T&              reference;
+
+        jagged_row() noe_std_no_except : m_data(0), m_size(0) {}
+        jagged_row(T* data, size_type size) noe_std_no_except : m_data(data), m_size(size) {}
+        // row to const row
+        template<class U,
+                 class = typename std::enable_if<std::is_convertible<U*, T*>::value>::type>
+        jagged_row(const jagged_row<U>& rhs) noe_std_no_except : m_data(rhs.data()), m_size(rhs.size()) {}
+
+        T* data() const noe_std_no_except { return m_data; }
+        size_type size() const noe_std_no_except { return m_size; }
+        bool empty() const noe_std_no_except { return m_size == 0; }
+        T& operator[](size_type n) const { return m_data[n]; }
+        T& front() const { return m_data[0]; }
+        T& back() const { return m_data[m_size - 1]; }
+        T* begin() const noe_std_no_except { return m_data; }
+        T* end() const noe_std_no_except { return m_data + m_size; }
+
+    private:
+        T*          m_data;
+        size_type   m_size;
+    };
+
+    /// Vector of variable length rows in compressed sparse row layout: the elements of all rows live
+    /// back to back in one flat noe_std::vector and a second one holds where each row ends, so N rows
+    /// cost two allocations instead of N + 1 and a scan over every row walks memory sequentially.
+    /// OffsetT can be narrowed (e.g. uint32_t) to halve the index when the element count allows it.
+    /// Row views point into the flat buffer and are invalidated by any insertion.
+    /// Insertions return false (and leave the vector untouched) if allocation fails or the element
+    /// count would no longer fit in OffsetT.
+    template<class T, class AllocatorT = allocator<T>, class OffsetT = std::size_t>
+    class jagged_vector
+    {
+        typedef typename std::allocator_traits<AllocatorT>::template rebind_alloc<OffsetT>   offset_allocator_t;
+
+    public:
+        typedef jagged_row<T>                                           value_type;
+        typedef jagged_row<T>                                           reference;
+        typedef jagged_row<const T>                                     const_reference;
+        typedef std::size_t                                             size_type;
+        typedef OffsetT                                                 offset_type;
+        typedef detail::indexed_iterator<jagged_vector, reference>      iterator;
+        typedef detail::indexed_iterator<const jagged_vector, const_reference>  const_iterator;
+
+        jagged_vector() noe_std_no_except {}
+        // the copy is left empty if allocation fails
+        jagged_vector(const jagged_vector& rhs);
+        jagged_vector& operator=(const jagged_vector& rhs);
+        jagged_vector(jagged_vector&& rhs) = default;
+        jagged_vector& operator=(jagged_vector&& rhs) = default;
+
+        // rows
+        size_type size() const noe_std_no_except { return m_ends.size(); }
+        bool empty() const noe_std_no_except { return m_ends.size() == 0; }
+        size_type row_size(size_type n) const noe_std_no_except { return m_ends[n] - row_begin(n); }
+        // elements of all rows together
+        size_type value_count() const noe_std_no_except { return m_ends.size() ? size_type(m_ends.back()) : 0; }
+        const vector<T, AllocatorT>& values() const noe_std_no_except { return m_values; }
+        // end offset of every row into values(), row n starts where row n - 1 ends
+        const vector<OffsetT, offset_allocator_t>& offsets() const noe_std_no_except { return m_ends; }
+
+        reference operator[](size_type n) { return reference(m_values.data() + row_begin(n), row_size(n)); }
+        const_reference operator[](size_type n) const { return const_reference(m_values.data() + row_begin(n), row_size(n)); }
+        reference back() { return (*this)[size() - 1]; }
+        const_reference back() const { return (*this)[size() - 1]; }
+
+        iterator begin() { return iterator(this, 0); }
+        const_iterator begin() const { return const_iterator(this, 0); }
+        const_iterator cbegin() const { return const_iterator(this, 0); }
+        iterator end() { return iterator(this, size()); }
+        const_iterator end() const { return const_iterator(this, size()); }
+        const_iterator cend() const { return const_iterator(this, size()); }
+
+        // appends one row, the iterator range must not point into this vector
+        template<class InputIt> bool push_back(InputIt first, InputIt last);
+        // appends one row, the source may be a row of this vector
+        bool push_back(const T* data, size_type n);
+        bool push_back(std::initializer_list<T> row) { return push_back(row.begin(), row.size()); }
+        template<class U> bool push_back(const jagged_row<U>& row) { return push_back(row.data(), row.size()); }
+        // bulk append of every row of rhs (which may be this vector) with one growth per buffer
+        bool append(const jagged_vector& rhs);
+        void pop_back();
+
+        void reserve(size_type rows, size_type values) { m_ends.reserve(rows); m_values.reserve(values); }
+        void shrink_to_fit() { m_values.shrink_to_fit(); m_ends.shrink_to_fit(); }
+        void clear() { m_values.clear(); m_ends.clear(); }
+        void swap(jagged_vector& other) noe_std_no_except { m_values.swap(other.m_values); m_ends.swap(other.m_ends); }
+
+    private:
+        size_type row_begin(size_type n) const noe_std_no_except { return n ? size_type(m_ends[n - 1]) : 0; }
+        void truncate(size_type count) { m_values.erase(m_values.begin() + count, m_values.end()); }
+        bool append_values(const T* src, size_type n);
+        static bool fits(size_type count) noe_std_no_except { return count <= size_type(std::numeric_limits<OffsetT>::max()); }
+
+        vector<T, AllocatorT> m_values;
+        vector<OffsetT, offset_allocator_t> m_ends;
+    };
+
+    template<class T, class AllocatorT, class OffsetT>
+    jagged_vector<T, AllocatorT, OffsetT>::jagged_vector(const jagged_vector& rhs) :
+        m_values(rhs.m_values), m_ends(rhs.m_ends)
+    {
+        // each vector comes back empty if its allocation failed, rows must not point past the values
+        if(m_values.size() != rhs.m_values.size() || m_ends.size() != rhs.m_ends.size())
+            clear();
+    }
+
+    template<class T, class AllocatorT, class OffsetT>
+    jagged_vector<T, AllocatorT, OffsetT>& jagged_vector<T, AllocatorT, OffsetT>::operator=(const jagged_vector& rhs)
+    {
+        jagged_vector tmp(rhs);
+        swap(tmp);
+        return *this;
+    }
+
+    template<class T, class AllocatorT, class OffsetT>
+    template<class InputIt>
+    bool jagged_vector<T, AllocatorT, OffsetT>::push_back(InputIt first, InputIt last)
+    {
+        size_type old_count = m_values.size();
+        if(!m_values.append(first, last))
+            return false;
+        if(!fits(m_values.size()) || !m_ends.push_back(OffsetT(m_values.size()))) {
+            truncate(old_count);
+            return false;
+        }
+        return true;
+    }
+
+    template<class T, class AllocatorT, class OffsetT>
+    bool jagged_vector<T, AllocatorT, OffsetT>::push_back(const T* data, size_type n)
+    {
+        size_type old_count = m_values.size();
+        if(!fits(old_count + n) || !append_values(data, n))
+            return false;
+        if(!m_ends.push_back(OffsetT(m_values.size()))) {
+            truncate(old_count);
+            return false;
+        }
+        return true;
+    }
+
+    template<class T, class AllocatorT, class OffsetT>
+    bool jagged_vector<T, AllocatorT, OffsetT>::append(const jagged_vector& rhs)
+    {
+        // counts are taken up front, rhs may be this vector
+        size_type rows = rhs.size();
+        size_type count = rhs.value_count();
+        size_type base = m_values.size();
+        if(!fits(base + count))
+            return false;
+        if(!append_values(rhs.m_values.data(), count))
+            return false;
+        OffsetT* ends = m_ends.append_uninitialized(rows);
+        if(!ends) {
+            truncate(base);
+            return false;
+        }
+        const OffsetT* src = rhs.m_ends.data();
+        for(size_type i = 0; i < rows; ++i)
+            ends[i] = OffsetT(base + size_type(src[i]));
+        m_ends.commit(rows);
+        return true;
+    }
+
+    template<class T, class AllocatorT, class OffsetT>
+    void jagged_vector<T, AllocatorT, OffsetT>::pop_back()
+    {
+        truncate(row_begin(size() - 1));
+        m_ends.pop_back();
+    }
+
+    template<class T, class AllocatorT, class OffsetT>
+    bool jagged_vector<T, AllocatorT, OffsetT>::append_values(const T* src, size_type n)
+    {
+        if(n == 0)
+            return true;
+        // growth may move the buffer (also in place through realloc), so a source inside it is
+        // tracked by its offset and looked up again once the room is made
+        const T* data = m_values.data();
+        bool inside = src >= data && src < data + m_values.size();
+        size_type offset = inside ? size_type(src - data) : 0;
+        T* dst = m_values.append_uninitialized(n);
+        if(!dst)
+            return false;
+        if(inside)
+            src = m_values.data() + offset;
+        std::uninitialized_copy(src, src + n, dst);
+        m_values.commit(n);
+        return true;
+    }
+
+    template<class T, class AllocatorT, class OffsetT>
+    inline void swap(jagged_vector<T, AllocatorT, OffsetT>& v1, jagged_vector<T, AllocatorT, OffsetT>& v2) noe_std_no_except
+    {
+        v1.swap(v2);
+    }
+}
+
+#endif // GUARD_NOE_STD_jagged_vector_H
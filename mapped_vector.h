@@ -0,0 +1,425 @@
+/**
+ * NoException Standard Library Container Implementation
+ * by Marvin Manese 2017
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+#ifndef GUARD_NOE_STD_mapped_vector_H
+#define GUARD_NOE_STD_mapped_vector_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "growth_policy.h"
+#include "macro.h"
+
+namespace noe_std
+{
+namespace detail
+{
+    /// Stored at the start of the file, the elements follow at mapped_vector::header_bytes
+    struct mapped_vector_header
+    {
+        char                m_magic[8];
+        unsigned long long  m_element_size;
+        unsigned long long  m_element_align;
+        unsigned long long  m_size;
+    };
+
+    inline const char* mapped_vector_magic() { return "noevec01"; }
+}
+    /// vector whose elements live in a memory mapped file, so they survive the process.
+    /// open attaches to an existing file in O(1) (map and check the header, nothing is read or rebuilt),
+    /// growing extends the file and remaps it (mremap on Linux), elements are never copied and
+    /// the page cache holds the only copy, so a huge array does not need twice its size to grow.
+    /// T must be trivially copyable since its bytes are reused across processes.
+    /// All operations return false (or leave the vector untouched) if the file can not be grown or mapped.
+    /// Changes reach the file through the page cache, flush forces them to disk.
+    template<class T,
+             class GrowthPolicyT = double_growth_policy>
+    class mapped_vector
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "mapped_vector needs a trivially copyable element type");
+
+    public:
+        typedef T                   value_type;
+        typedef std::size_t         size_type;
+        typedef std::ptrdiff_t      difference_type;
+        typedef value_type&         reference;
+        typedef const value_type&   const_reference;
+        typedef value_type*         pointer;
+        typedef const value_type*   const_pointer;
+        typedef pointer             iterator;
+        typedef const_pointer       const_iterator;
+
+        /// Offset of the first element in the file
+        enum : std::size_t { header_bytes = alignof(T) > 64 ? alignof(T) : 64 };
+
+        mapped_vector() noe_std_no_except : m_fd(-1), m_base(0), m_mapped_bytes(0), m_file_bytes(0), m_capacity(0) {}
+        mapped_vector(mapped_vector&& rhs) noe_std_no_except;
+        mapped_vector& operator=(mapped_vector&& rhs) noe_std_no_except;
+        ~mapped_vector() { close(); }
+
+        /// Attaches to path, creating an empty vector there if create is set and the file does not exist.
+        /// Fails if the file was written for a different element size or alignment.
+        bool open(const char* path, bool create = true) noe_std_no_except;
+        void close() noe_std_no_except;
+        bool is_open() const noe_std_no_except { return m_base != 0; }
+        /// Writes dirty pages back to the file
+        bool flush() noe_std_no_except;
+
+        reference operator[](size_type n) { return data()[n]; }
+        const_reference operator[](size_type n) const { return data()[n]; }
+        reference front() { return data()[0]; }
+        const_reference front() const { return data()[0]; }
+        reference back() { return data()[size() - 1]; }
+        const_reference back() const { return data()[size() - 1]; }
+        pointer data() noe_std_no_except { return reinterpret_cast<pointer>(m_base + header_bytes); }
+        const_pointer data() const noe_std_no_except { return reinterpret_cast<const_pointer>(m_base + header_bytes); }
+
+        iterator begin() noe_std_no_except { return data(); }
+        const_iterator begin() const noe_std_no_except { return data(); }
+        const_iterator cbegin() const noe_std_no_except { return data(); }
+        iterator end() noe_std_no_except { return data() + size(); }
+        const_iterator end() const noe_std_no_except { return data() + size(); }
+        const_iterator cend() const noe_std_no_except { return data() + size(); }
+
+        bool empty() const noe_std_no_except { return (size() == 0); }
+        size_type size() const noe_std_no_except { return m_base ? static_cast<size_type>(header()->m_size) : 0; }
+        size_type max_size() const noe_std_no_except { return (std::numeric_limits<size_type>::max() - header_bytes) / sizeof(T); }
+        size_type capacity() const noe_std_no_except { return m_capacity; }
+        bool reserve(size_type n) noe_std_no_except;
+        /// Truncates the mapping and the file to the pages the elements need
+        bool shrink_to_fit() noe_std_no_except;
+
+        void clear() noe_std_no_except { if(m_base) header()->m_size = 0; }
+        bool push_back(const_reference v) noe_std_no_except;
+        template<class... Args> bool emplace_back(Args&&... args);
+        template<class InputIt> bool append(InputIt first, InputIt last);
+        bool append(std::initializer_list<T> init_list) { return append(init_list.begin(), init_list.end()); }
+        void pop_back() noe_std_no_except { --header()->m_size; }
+        void erase(iterator first, iterator last) noe_std_no_except;
+        void erase(iterator it) noe_std_no_except { erase(it, it + 1); }
+        bool resize(size_type n) noe_std_no_except { return resize(n, T()); }
+        bool resize(size_type n, const_reference v) noe_std_no_except;
+        void swap(mapped_vector& other) noe_std_no_except;
+
+    private:
+        mapped_vector(const mapped_vector&);
+        mapped_vector& operator=(const mapped_vector&);
+
+        detail::mapped_vector_header* header() noe_std_no_except { return reinterpret_cast<detail::mapped_vector_header*>(m_base); }
+        const detail::mapped_vector_header* header() const noe_std_no_except { return reinterpret_cast<const detail::mapped_vector_header*>(m_base); }
+        void set_size(size_type n) noe_std_no_except { header()->m_size = n; }
+
+        static size_type page_size() noe_std_no_except { return static_cast<size_type>(::sysconf(_SC_PAGESIZE)); }
+        bool file_bytes(size_type capacity, size_type& bytes) const noe_std_no_except;
+        bool remap(size_type new_bytes) noe_std_no_except;
+        bool grow(size_type new_capacity) noe_std_no_except;
+        bool check_capacity(size_type required) noe_std_no_except;
+
+        int             m_fd;
+        unsigned char*  m_base;
+        size_type       m_mapped_bytes;
+        size_type       m_file_bytes;   // above m_mapped_bytes if truncating the file back failed
+        size_type       m_capacity;
+    };
+
+    template<class T, class GrowthPolicyT>
+    mapped_vector<T, GrowthPolicyT>::mapped_vector(mapped_vector&& rhs) noe_std_no_except
+        : m_fd(rhs.m_fd), m_base(rhs.m_base), m_mapped_bytes(rhs.m_mapped_bytes), m_file_bytes(rhs.m_file_bytes), m_capacity(rhs.m_capacity)
+    {
+        rhs.m_fd = -1;
+        rhs.m_base = 0;
+        rhs.m_mapped_bytes = 0;
+        rhs.m_file_bytes = 0;
+        rhs.m_capacity = 0;
+    }
+
+    template<class T, class GrowthPolicyT>
+    mapped_vector<T, GrowthPolicyT>& mapped_vector<T, GrowthPolicyT>::operator=(mapped_vector&& rhs) noe_std_no_except
+    {
+        if(this != &rhs) {
+            close();
+            swap(rhs);
+        }
+        return *this;
+    }
+
+    template<class T, class GrowthPolicyT>
+    bool mapped_vector<T, GrowthPolicyT>::open(const char* path, bool create) noe_std_no_except
+    {
+        close();
+        int fd = ::open(path, O_RDWR | (create ? O_CREAT : 0), 0644);
+        if(fd < 0)
+            return false;
+
+        struct stat st;
+        if(::fstat(fd, &st) != 0) {
+            ::close(fd);
+            return false;
+        }
+        size_type bytes = static_cast<size_type>(st.st_size);
+        const bool fresh = (bytes == 0);
+        if(fresh) {
+            // new file, a page for the header and the first elements
+            file_bytes(0, bytes);
+            if(::ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+                ::close(fd);
+                return false;
+            }
+        }
+        else if(bytes < header_bytes) {
+            ::close(fd);
+            return false;
+        }
+
+        void* base = ::mmap(0, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if(base == MAP_FAILED) {
+            ::close(fd);
+            return false;
+        }
+        detail::mapped_vector_header* h = static_cast<detail::mapped_vector_header*>(base);
+        if(fresh) {
+            std::memcpy(h->m_magic, detail::mapped_vector_magic(), sizeof(h->m_magic));
+            h->m_element_size = sizeof(T);
+            h->m_element_align = alignof(T);
+            h->m_size = 0;
+        }
+        size_type capacity = (bytes - header_bytes) / sizeof(T);
+        if(std::memcmp(h->m_magic, detail::mapped_vector_magic(), sizeof(h->m_magic)) != 0 ||
+           h->m_element_size != sizeof(T) || h->m_element_align != alignof(T) || h->m_size > capacity) {
+            ::munmap(base, bytes);
+            ::close(fd);
+            return false;
+        }
+
+        m_fd = fd;
+        m_base = static_cast<unsigned char*>(base);
+        m_mapped_bytes = bytes;
+        m_file_bytes = bytes;
+        m_capacity = capacity;
+        return true;
+    }
+
+    template<class T, class GrowthPolicyT>
+    void mapped_vector<T, GrowthPolicyT>::close() noe_std_no_except
+    {
+        if(m_base)
+            ::munmap(m_base, m_mapped_bytes);
+        if(m_fd >= 0)
+            ::close(m_fd);
+        m_fd = -1;
+        m_base = 0;
+        m_mapped_bytes = 0;
+        m_file_bytes = 0;
+        m_capacity = 0;
+    }
+
+    template<class T, class GrowthPolicyT>
+    bool mapped_vector<T, GrowthPolicyT>::flush() noe_std_no_except
+    {
+        return m_base && ::msync(m_base, m_mapped_bytes, MS_SYNC) == 0;
+    }
+
+    template<class T, class GrowthPolicyT>
+    bool mapped_vector<T, GrowthPolicyT>::reserve(size_type n) noe_std_no_except
+    {
+        if(n <= m_capacity)
+            return m_base != 0;
+        return grow(std::max(n, GrowthPolicyT::fit(n, sizeof(T))));
+    }
+
+    template<class T, class GrowthPolicyT>
+    bool mapped_vector<T, GrowthPolicyT>::shrink_to_fit() noe_std_no_except
+    {
+        if(!m_base)
+            return false;
+        size_type bytes = 0;
+        if(!file_bytes(size(), bytes))
+            return true;
+        // unmap the tail before the file loses it
+        if(bytes < m_mapped_bytes) {
+            if(!remap(bytes))
+                return false;
+            m_capacity = (bytes - header_bytes) / sizeof(T);
+        }
+        // the file may also still be longer than the mapping from a failed grow
+        if(bytes >= m_file_bytes)
+            return true;
+        if(::ftruncate(m_fd, static_cast<off_t>(bytes)) != 0)
+            return false;
+        m_file_bytes = bytes;
+        return true;
+    }
+
+    template<class T, class GrowthPolicyT>
+    bool mapped_vector<T, GrowthPolicyT>::push_back(const_reference v) noe_std_no_except
+    {
+        // v may live in the mapping, which grow can move
+        T value(v);
+        if(!check_capacity(size() + 1))
+            return false;
+        size_type n = size();
+        std::memcpy(static_cast<void*>(data() + n), static_cast<const void*>(&value), sizeof(T));
+        set_size(n + 1);
+        return true;
+    }
+
+    template<class T, class GrowthPolicyT>
+    template<class... Args>
+    bool mapped_vector<T, GrowthPolicyT>::emplace_back(Args&&... args)
+    {
+        return push_back(T(std::forward<Args>(args)...));
+    }
+
+    template<class T, class GrowthPolicyT>
+    template<class InputIt>
+    bool mapped_vector<T, GrowthPolicyT>::append(InputIt first, InputIt last)
+    {
+        size_type old_size = size();
+        for(; first != last; ++first) {
+            if(!push_back(T(*first))) {
+                if(m_base)
+                    set_size(old_size);
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template<class T, class GrowthPolicyT>
+    void mapped_vector<T, GrowthPolicyT>::erase(iterator first, iterator last) noe_std_no_except
+    {
+        size_type n = size();
+        std::memmove(static_cast<void*>(first), static_cast<const void*>(last), (end() - last) * sizeof(T));
+        set_size(n - (last - first));
+    }
+
+    template<class T, class GrowthPolicyT>
+    bool mapped_vector<T, GrowthPolicyT>::resize(size_type n, const_reference v) noe_std_no_except
+    {
+        size_type old_size = size();
+        if(n > old_size) {
+            T value(v);
+            if(!check_capacity(n))
+                return false;
+            for(pointer p = data() + old_size, p_end = data() + n; p != p_end; ++p)
+                std::memcpy(static_cast<void*>(p), static_cast<const void*>(&value), sizeof(T));
+        }
+        else if(!m_base) {
+            return n == 0;
+        }
+        set_size(n);
+        return true;
+    }
+
+    template<class T, class GrowthPolicyT>
+    void mapped_vector<T, GrowthPolicyT>::swap(mapped_vector& other) noe_std_no_except
+    {
+        std::swap(m_fd, other.m_fd);
+        std::swap(m_base, other.m_base);
+        std::swap(m_mapped_bytes, other.m_mapped_bytes);
+        std::swap(m_file_bytes, other.m_file_bytes);
+        std::swap(m_capacity, other.m_capacity);
+    }
+
+    template<class T, class GrowthPolicyT>
+    bool mapped_vector<T, GrowthPolicyT>::file_bytes(size_type capacity, size_type& bytes) const noe_std_no_except
+    {
+        // the file always ends on a page boundary, the rest of the last page is capacity
+        const size_type page = page_size();
+        if(capacity > max_size() || header_bytes + capacity * sizeof(T) > std::numeric_limits<size_type>::max() - page)
+            return false;
+        bytes = (header_bytes + capacity * sizeof(T) + page - 1) / page * page;
+        return true;
+    }
+
+    template<class T, class GrowthPolicyT>
+    bool mapped_vector<T, GrowthPolicyT>::remap(size_type new_bytes) noe_std_no_except
+    {
+#if defined(__linux__)
+        void* base = ::mremap(m_base, m_mapped_bytes, new_bytes, MREMAP_MAYMOVE);
+        if(base == MAP_FAILED)
+            return false;
+#else
+        // no mremap, map the new length first so failure leaves the old mapping in place
+        void* base = ::mmap(0, new_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+        if(base == MAP_FAILED)
+            return false;
+        ::munmap(m_base, m_mapped_bytes);
+#endif // defined(__linux__)
+        m_base = static_cast<unsigned char*>(base);
+        m_mapped_bytes = new_bytes;
+        return true;
+    }
+
+    template<class T, class GrowthPolicyT>
+    bool mapped_vector<T, GrowthPolicyT>::grow(size_type new_capacity) noe_std_no_except
+    {
+        size_type bytes = 0;
+        if(!m_base || !file_bytes(new_capacity, bytes))
+            return false;
+        // extend the file, then the mapping, on failure the file goes back to its old length
+        if(bytes > m_file_bytes) {
+            if(::ftruncate(m_fd, static_cast<off_t>(bytes)) != 0)
+                return false;
+            m_file_bytes = bytes;
+        }
+        if(!remap(bytes)) {
+            // if that fails too the file stays longer (m_file_bytes), the next grow reuses the
+            // extra length and shrink_to_fit trims it, the size in the header bounds the elements
+            if(m_file_bytes > m_mapped_bytes && ::ftruncate(m_fd, static_cast<off_t>(m_mapped_bytes)) == 0)
+                m_file_bytes = m_mapped_bytes;
+            return false;
+        }
+        m_capacity = (bytes - header_bytes) / sizeof(T);
+        return true;
+    }
+
+    template<class T, class GrowthPolicyT>
+    bool mapped_vector<T, GrowthPolicyT>::check_capacity(size_type required) noe_std_no_except
+    {
+        if(required <= m_capacity)
+            return m_base != 0;
+        if(required > max_size())
+            return false;
+        return grow(std::max(required, std::min(GrowthPolicyT::grow(m_capacity, required, sizeof(T)), max_size())));
+    }
+}
+namespace std
+{
+    template<class T, class GrowthPolicyT>
+    inline void swap(noe_std::mapped_vector<T, GrowthPolicyT>& v1, noe_std::mapped_vector<T, GrowthPolicyT>& v2) noe_std_no_except
+    {
+        v1.swap(v2);
+    }
+}
+
+#endif // GUARD_NOE_STD_mapped_vector_H
@@ -0,0 +1,264 @@
+/**
+ * NoException Standard Library Container Implementation
+ * by Marvin Manese 2017
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+#ifndef GUARD_NOE_STD_packed_int_vector_H
+#define GUARD_NOE_STD_packed_int_vector_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include "allocator.h"
+#include "macro.h"
+#include "simd_algorithm.h"
+#include "vector.h"
+
+namespace noe_std
+{
+namespace detail
+{
+    inline std::uint64_t packed_mask(unsigned width) noe_std_no_except
+    {
+        return width >= 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << width) - 1;
+    }
+
+    inline std::size_t packed_words(std::size_t bits) noe_std_no_except
+    {
+        return (bits + 63) / 64;
+    }
+
+    /// Stores the low width bits of value at bit, the field may straddle two words
+    inline void packed_write(std::uint64_t* words, std::size_t bit, unsigned width, std::uint64_t value) noe_std_no_except
+    {
+        if(width == 0)
+            return;
+        std::uint64_t mask = packed_mask(width);
+        std::size_t word = bit >> 6;
+        unsigned offset = static_cast<unsigned>(bit & 63);
+        words[word] = (words[word] & ~(mask << offset)) | (value << offset);
+        if(offset + width > 64) {
+            unsigned high = 64 - offset;
+            words[word + 1] = (words[word + 1] & ~(mask >> high)) | (value >> high);
+        }
+    }
+
+    inline std::uint64_t packed_read(const std::uint64_t* words, std::size_t bit, unsigned width) noe_std_no_except
+    {
+        return width == 0 ? 0 : simd_extract_bits(words, bit, width);
+    }
+
+    /// Forward iterator for the packed containers, decodes batch_size values at a time with
+    /// the container's bulk decode, so a scan runs at the speed of the unpack kernel
+    template<class ContainerT>
+    class packed_iterator
+    {
+    public:
+        typedef std::forward_iterator_tag               iterator_category;
+        typedef std::uint64_t                           value_type;
+        typedef std::ptrdiff_t                          difference_type;
+        typedef std::uint64_t                           reference;
+        typedef void                                    pointer;
+
+        enum : std::size_t { batch_size = 32 };
+
+        packed_iterator() : m_container(0), m_index(0), m_batch_first(0), m_batch_size(0) {}
+        packed_iterator(const ContainerT* container, std::size_t index) : m_container(container), m_index(index), m_batch_first(0), m_batch_size(0) {}
+
+        reference operator*() const
+        {
+            if(m_index - m_batch_first >= m_batch_size) {
+                std::size_t left = m_container->size() - m_index;
+                m_batch_first = m_index;
+                m_batch_size = left < batch_size ? left : std::size_t(batch_size);
+                m_container->decode(m_index, m_batch_size, m_batch);
+            }
+            return m_batch[m_index - m_batch_first];
+        }
+        std::size_t index() const { return m_index; }
+
+        packed_iterator& operator++() { ++m_index; return *this; }
+        packed_iterator operator++(int) { packed_iterator it(*this); ++m_index; return it; }
+
+        bool operator==(const packed_iterator& rhs) const { return m_index == rhs.m_index; }
+        bool operator!=(const packed_iterator& rhs) const { return m_index != rhs.m_index; }
+
+    private:
+        const ContainerT*       m_container;
+        std::size_t             m_index;
+        mutable std::size_t     m_batch_first;
+        mutable std::size_t     m_batch_size;
+        mutable std::uint64_t   m_batch[batch_size];
+    };
+}
+    /// Unsigned integers stored back to back in width bits each. Width is a template argument when it
+    /// is known at build time (shifts and masks fold to constants), Width = 0 takes it at runtime.
+    /// Random access is one or two word reads, decode and the iterator unpack with the SIMD kernel.
+    /// Values that do not fit the width are rejected, growing operations return false (and leave the
+    /// vector untouched) if allocation fails. One zero padding word always follows the packed bits.
+    template<unsigned Width = 0, class AllocatorT = allocator<std::uint64_t> >
+    class packed_int_vector
+    {
+        static_assert(Width <= 64, "packed_int_vector holds at most 64 bit values");
+
+    public:
+        typedef std::uint64_t                                   value_type;
+        typedef std::size_t                                     size_type;
+        typedef detail::packed_iterator<packed_int_vector>      const_iterator;
+        typedef const_iterator                                  iterator;
+
+        packed_int_vector() noe_std_no_except : m_size(0), m_width(Width ? Width : 64) {}
+        // runtime width, ignored when Width is set
+        explicit packed_int_vector(unsigned width) noe_std_no_except : m_size(0), m_width(Width ? Width : (width > 64 ? 64 : width)) {}
+
+        /// Smallest width holding max_value
+        static unsigned bits_for(std::uint64_t max_value) noe_std_no_except;
+
+        unsigned width() const noe_std_no_except { return Width ? Width : m_width; }
+        size_type size() const noe_std_no_except { return m_size; }
+        bool empty() const noe_std_no_except { return m_size == 0; }
+        bool fits(std::uint64_t value) const noe_std_no_except { return (value & ~detail::packed_mask(width())) == 0; }
+        size_type memory_bytes() const noe_std_no_except { return m_words.capacity() * sizeof(std::uint64_t); }
+        const std::uint64_t* words() const noe_std_no_except { return m_words.data(); }
+        void reserve(size_type n) { m_words.reserve(detail::packed_words(n * width()) + 1); }
+        void shrink_to_fit() { m_words.shrink_to_fit(); }
+        void clear() { m_words.clear(); m_size = 0; }
+
+        value_type operator[](size_type n) const noe_std_no_except { return detail::packed_read(m_words.data(), n * width(), width()); }
+        value_type get(size_type n) const noe_std_no_except { return (*this)[n]; }
+        value_type back() const noe_std_no_except { return (*this)[m_size - 1]; }
+        // false if value does not fit the width
+        bool set(size_type n, value_type value) noe_std_no_except;
+        bool push_back(value_type value);
+        void pop_back() noe_std_no_except;
+        // new values are zero
+        bool resize(size_type n);
+        // rewrites every value with a new width (Width = 0 only), false if a value does not fit or allocation fails
+        bool repack(unsigned width);
+
+        // writes the n values from first on to out
+        void decode(size_type first, size_type n, value_type* out) const noe_std_no_except;
+        const_iterator begin() const { return const_iterator(this, 0); }
+        const_iterator end() const { return const_iterator(this, m_size); }
+
+    private:
+        bool grow_words(size_type bits);
+
+        vector<std::uint64_t, AllocatorT> m_words;
+        size_type m_size;
+        unsigned m_width;
+    };
+
+    template<unsigned Width, class AllocatorT>
+    unsigned packed_int_vector<Width, AllocatorT>::bits_for(std::uint64_t max_value) noe_std_no_except
+    {
+        unsigned bits = 0;
+        for(; max_value; max_value >>= 1)
+            ++bits;
+        return bits;
+    }
+
+    template<unsigned Width, class AllocatorT>
+    inline bool packed_int_vector<Width, AllocatorT>::set(size_type n, value_type value) noe_std_no_except
+    {
+        if(!fits(value))
+            return false;
+        detail::packed_write(m_words.data(), n * width(), width(), value);
+        return true;
+    }
+
+    template<unsigned Width, class AllocatorT>
+    bool packed_int_vector<Width, AllocatorT>::push_back(value_type value)
+    {
+        if(!fits(value) || !grow_words((m_size + 1) * width()))
+            return false;
+        detail::packed_write(m_words.data(), m_size * width(), width(), value);
+        ++m_size;
+        return true;
+    }
+
+    template<unsigned Width, class AllocatorT>
+    void packed_int_vector<Width, AllocatorT>::pop_back() noe_std_no_except
+    {
+        // the freed bits go back to zero, so the padding after the last value stays clean
+        --m_size;
+        detail::packed_write(m_words.data(), m_size * width(), width(), 0);
+    }
+
+    template<unsigned Width, class AllocatorT>
+    bool packed_int_vector<Width, AllocatorT>::resize(size_type n)
+    {
+        if(n > m_size) {
+            if(!grow_words(n * width()))
+                return false;
+        } else {
+            for(size_type i = n; i < m_size; ++i)
+                detail::packed_write(m_words.data(), i * width(), width(), 0);
+            m_words.resize_default_init(n ? detail::packed_words(n * width()) + 1 : 0);
+        }
+        m_size = n;
+        return true;
+    }
+
+    template<unsigned Width, class AllocatorT>
+    bool packed_int_vector<Width, AllocatorT>::repack(unsigned new_width)
+    {
+        static_assert(Width == 0, "repack needs a runtime width");
+        if(new_width > 64)
+            return false;
+        packed_int_vector other(new_width);
+        if(m_size && !other.grow_words(m_size * new_width))
+            return false;
+        for(size_type i = 0; i < m_size; ++i) {
+            value_type value = (*this)[i];
+            if(!other.fits(value))
+                return false;
+            detail::packed_write(other.m_words.data(), i * new_width, new_width, value);
+        }
+        other.m_size = m_size;
+        m_words.swap(other.m_words);
+        m_width = new_width;
+        return true;
+    }
+
+    template<unsigned Width, class AllocatorT>
+    inline void packed_int_vector<Width, AllocatorT>::decode(size_type first, size_type n, value_type* out) const noe_std_no_except
+    {
+        if(n)
+            simd::unpack_bits(m_words.data(), first * width(), width(), n, out);
+    }
+
+    template<unsigned Width, class AllocatorT>
+    bool packed_int_vector<Width, AllocatorT>::grow_words(size_type bits)
+    {
+        // new words (and the padding word) start out zero
+        size_type old_size = m_words.size();
+        size_type new_size = detail::packed_words(bits) + 1;
+        if(new_size <= old_size)
+            return true;
+        if(!m_words.resize_default_init(new_size))
+            return false;
+        for(size_type i = old_size; i < new_size; ++i)
+            m_words[i] = 0;
+        return true;
+    }
+}
+
+#endif // GUARD_NOE_STD_packed_int_vector_H
@@ -0,0 +1,214 @@
+/**
+ * NoException Standard Library Container Implementation
+ * by Marvin Manese 2017
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+#ifndef GUARD_NOE_STD_parallel_algorithm_H
+#define GUARD_NOE_STD_parallel_algorithm_H
+
+#include <cstddef>
+#include <utility>
+#include "macro.h"
+#include "thread_pool.h"
+#include "vector.h"
+
+/// Parallel for_each / transform / reduce / inclusive_scan over contiguous ranges and vectors.
+/// Ranges are cut into chunks of about parallel_chunk_bytes so each chunk stays in a core's cache,
+/// the chunks run on a thread_pool (inline if the pool is not running).
+/// reduce and inclusive_scan need op to be associative, chunks are combined in order.
+/// Every algorithm returns false if it could not allocate its output or scratch space.
+namespace noe_std
+{
+    enum : std::size_t { parallel_chunk_bytes = 32 * 1024 };
+namespace detail
+{
+    template<class T>
+    inline std::size_t parallel_chunk_size() noe_std_no_except
+    {
+        return sizeof(T) >= parallel_chunk_bytes ? 1 : parallel_chunk_bytes / sizeof(T);
+    }
+
+    inline std::size_t parallel_chunk_count(std::size_t n, std::size_t chunk) noe_std_no_except
+    {
+        return n / chunk + (n % chunk != 0);
+    }
+
+    template<class T, class F>
+    struct parallel_for_each_context
+    {
+        T*          m_data;
+        std::size_t m_size;
+        std::size_t m_chunk;
+        F*          m_f;
+
+        static void run(void* context, std::size_t first, std::size_t last)
+        {
+            parallel_for_each_context& c = *static_cast<parallel_for_each_context*>(context);
+            T* p = c.m_data + first * c.m_chunk;
+            T* p_end = c.m_data + (last * c.m_chunk < c.m_size ? last * c.m_chunk : c.m_size);
+            for(; p != p_end; ++p)
+                (*c.m_f)(*p);
+        }
+    };
+
+    template<class T, class U, class F>
+    struct parallel_transform_context
+    {
+        const T*    m_in;
+        U*          m_out;
+        std::size_t m_size;
+        std::size_t m_chunk;
+        F*          m_f;
+
+        static void run(void* context, std::size_t first, std::size_t last)
+        {
+            parallel_transform_context& c = *static_cast<parallel_transform_context*>(context);
+            std::size_t i_end = last * c.m_chunk < c.m_size ? last * c.m_chunk : c.m_size;
+            for(std::size_t i = first * c.m_chunk; i != i_end; ++i)
+                c.m_out[i] = (*c.m_f)(c.m_in[i]);
+        }
+    };
+
+    /// Folds every chunk into m_partials, scan_apply optionally rewrites the chunk as a running fold
+    template<class T, class Op>
+    struct parallel_fold_context
+    {
+        const T*    m_in;
+        T*          m_out;          // inclusive_scan output, 0 for reduce
+        T*          m_partials;     // one per chunk, in the second scan pass the carry into each chunk
+        std::size_t m_size;
+        std::size_t m_chunk;
+        Op*         m_op;
+
+        static void fold(void* context, std::size_t first, std::size_t last)
+        {
+            parallel_fold_context& c = *static_cast<parallel_fold_context*>(context);
+            for(std::size_t k = first; k != last; ++k) {
+                std::size_t i = k * c.m_chunk;
+                std::size_t i_end = i + c.m_chunk < c.m_size ? i + c.m_chunk : c.m_size;
+                T acc = c.m_in[i];
+                for(++i; i != i_end; ++i)
+                    acc = (*c.m_op)(acc, c.m_in[i]);
+                c.m_partials[k] = acc;
+            }
+        }
+
+        static void scan(void* context, std::size_t first, std::size_t last)
+        {
+            parallel_fold_context& c = *static_cast<parallel_fold_context*>(context);
+            for(std::size_t k = first; k != last; ++k) {
+                std::size_t i = k * c.m_chunk;
+                std::size_t i_end = i + c.m_chunk < c.m_size ? i + c.m_chunk : c.m_size;
+                T acc = k ? (*c.m_op)(c.m_partials[k - 1], c.m_in[i]) : c.m_in[i];
+                c.m_out[i] = acc;
+                for(++i; i != i_end; ++i) {
+                    acc = (*c.m_op)(acc, c.m_in[i]);
+                    c.m_out[i] = acc;
+                }
+            }
+        }
+    };
+}
+    template<class T, class F>
+    bool parallel_for_each(thread_pool& pool, T* data, std::size_t n, F f)
+    {
+        detail::parallel_for_each_context<T, F> context = { data, n, detail::parallel_chunk_size<T>(), &f };
+        pool.run(detail::parallel_chunk_count(n, context.m_chunk), &detail::parallel_for_each_context<T, F>::run, &context);
+        return true;
+    }
+
+    template<class T, class AllocatorT, class GrowthPolicyT, class F>
+    inline bool parallel_for_each(thread_pool& pool, vector<T, AllocatorT, GrowthPolicyT>& v, F f)
+    {
+        return parallel_for_each(pool, v.data(), v.size(), f);
+    }
+
+    /// out[i] = f(in[i]), out must hold n elements
+    template<class T, class U, class F>
+    bool parallel_transform(thread_pool& pool, const T* in, std::size_t n, U* out, F f)
+    {
+        detail::parallel_transform_context<T, U, F> context = { in, out, n, detail::parallel_chunk_size<T>(), &f };
+        pool.run(detail::parallel_chunk_count(n, context.m_chunk), &detail::parallel_transform_context<T, U, F>::run, &context);
+        return true;
+    }
+
+    /// Resizes out to in.size(), false if it could not
+    template<class T, class AllocatorT, class GrowthPolicyT, class U, class AllocatorU, class GrowthPolicyU, class F>
+    bool parallel_transform(thread_pool& pool, const vector<T, AllocatorT, GrowthPolicyT>& in, vector<U, AllocatorU, GrowthPolicyU>& out, F f)
+    {
+        if(!out.resize_default_init(in.size()))
+            return false;
+        return parallel_transform(pool, in.data(), in.size(), out.data(), f);
+    }
+
+    /// result = init op data[0] op ... op data[n - 1]
+    template<class T, class Op>
+    bool parallel_reduce(thread_pool& pool, const T* data, std::size_t n, T init, Op op, T& result)
+    {
+        const std::size_t chunk = detail::parallel_chunk_size<T>();
+        const std::size_t chunks = detail::parallel_chunk_count(n, chunk);
+        vector<T> partials;
+        if(!partials.resize_default_init(chunks))
+            return false;
+
+        detail::parallel_fold_context<T, Op> context = { data, 0, partials.data(), n, chunk, &op };
+        pool.run(chunks, &detail::parallel_fold_context<T, Op>::fold, &context);
+        for(std::size_t k = 0; k < chunks; ++k)
+            init = op(init, partials[k]);
+        result = init;
+        return true;
+    }
+
+    template<class T, class AllocatorT, class GrowthPolicyT, class Op>
+    inline bool parallel_reduce(thread_pool& pool, const vector<T, AllocatorT, GrowthPolicyT>& v, T init, Op op, T& result)
+    {
+        return parallel_reduce(pool, v.data(), v.size(), init, op, result);
+    }
+
+    /// out[i] = in[0] op ... op in[i], out must hold n elements and may be in
+    template<class T, class Op>
+    bool parallel_inclusive_scan(thread_pool& pool, const T* in, std::size_t n, T* out, Op op)
+    {
+        // fold every chunk, scan the chunk totals, then rescan every chunk from its carry
+        const std::size_t chunk = detail::parallel_chunk_size<T>();
+        const std::size_t chunks = detail::parallel_chunk_count(n, chunk);
+        vector<T> partials;
+        if(!partials.resize_default_init(chunks))
+            return false;
+
+        detail::parallel_fold_context<T, Op> context = { in, out, partials.data(), n, chunk, &op };
+        pool.run(chunks, &detail::parallel_fold_context<T, Op>::fold, &context);
+        for(std::size_t k = 1; k < chunks; ++k)
+            partials[k] = op(partials[k - 1], partials[k]);
+        pool.run(chunks, &detail::parallel_fold_context<T, Op>::scan, &context);
+        return true;
+    }
+
+    /// Resizes out to in.size(), false if it could not
+    template<class T, class AllocatorT, class GrowthPolicyT, class AllocatorU, class GrowthPolicyU, class Op>
+    bool parallel_inclusive_scan(thread_pool& pool, const vector<T, AllocatorT, GrowthPolicyT>& in, vector<T, AllocatorU, GrowthPolicyU>& out, Op op)
+    {
+        if(!out.resize_default_init(in.size()))
+            return false;
+        return parallel_inclusive_scan(pool, in.data(), in.size(), out.data(), op);
+    }
+}
+
+#endif // GUARD_NOE_STD_parallel_algorithm_H
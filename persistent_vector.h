@@ -0,0 +1,628 @@
+/**
+ * NoException Standard Library Container Implementation
+ * by Marvin Manese 2017
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+#ifndef GUARD_NOE_STD_persistent_vector_H
+#define GUARD_NOE_STD_persistent_vector_H
+
+#include <atomic>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include "allocator.h"
+#include "macro.h"
+#include "detail/indexed_iterator.h"
+
+namespace noe_std
+{
+namespace detail
+{
+    enum : std::size_t
+    {
+        persistent_vector_bits = 5,
+        persistent_vector_width = std::size_t(1) << persistent_vector_bits,
+        persistent_vector_mask = persistent_vector_width - 1,
+        // enough inner levels to index any size_t, plus a new root
+        persistent_vector_max_path = (sizeof(std::size_t) * 8 + persistent_vector_bits - 1) / persistent_vector_bits + 1
+    };
+
+    struct persistent_vector_node
+    {
+        std::atomic<std::size_t> m_refs;
+    };
+
+    struct persistent_vector_inner : persistent_vector_node
+    {
+        persistent_vector_node* m_children[persistent_vector_width];
+    };
+
+    /// Leaves of the trie are always full, the tail leaf is shared between versions that agree on its
+    /// first elements: m_count elements are constructed and each version only reads its own prefix
+    template<class T>
+    struct persistent_vector_leaf : persistent_vector_node
+    {
+        std::atomic<std::size_t> m_count;
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type m_values[persistent_vector_width];
+
+        T* values() noe_std_no_except { return reinterpret_cast<T*>(m_values); }
+    };
+}
+    /// Vector with structural sharing: a 32 way trie of full leaves plus a tail leaf, nodes are reference
+    /// counted and shared between versions. Copying is O(1) and gives an independent version, later
+    /// changes to either copy path copy the touched nodes (log32 n of them) and share everything else.
+    /// push_back appends to the tail in O(1), the tail joins the trie once it holds 32 elements.
+    /// Transient editing is implicit: a node referenced by a single version is changed in place, so a
+    /// batch of edits after taking a snapshot copies each touched path once and then works in place.
+    /// take / slice share the kept prefix (slice keeps the trie and hides the elements before first),
+    /// append shares whole leaves when both sides line up on a leaf boundary and copies otherwise.
+    /// Modifying operations return false (and leave the vector untouched) if allocation fails.
+    /// Different versions may be used from different threads, a single version is not synchronized.
+    template<class T, class AllocatorT = allocator<T> >
+    class persistent_vector
+    {
+        typedef detail::persistent_vector_node                                                  node_t;
+        typedef detail::persistent_vector_inner                                                 inner_t;
+        typedef detail::persistent_vector_leaf<T>                                               leaf_t;
+        typedef typename std::allocator_traits<AllocatorT>::template rebind_alloc<inner_t>      inner_allocator_t;
+        typedef typename std::allocator_traits<AllocatorT>::template rebind_alloc<leaf_t>       leaf_allocator_t;
+
+        enum : std::size_t
+        {
+            bits = detail::persistent_vector_bits,
+            width = detail::persistent_vector_width,
+            mask = detail::persistent_vector_mask
+        };
+
+        /// Nodes allocated before an edit starts, so the edit itself can not fail half way
+        struct node_stash
+        {
+            inner_t*    m_inner[detail::persistent_vector_max_path];
+            std::size_t m_inner_count;
+            leaf_t*     m_leaf;
+        };
+
+    public:
+        typedef T                                                       value_type;
+        typedef AllocatorT                                              allocator_type;
+        typedef std::size_t                                             size_type;
+        typedef std::ptrdiff_t                                          difference_type;
+        typedef const T&                                                const_reference;
+        typedef detail::indexed_iterator<const persistent_vector, const T&, const T*>  const_iterator;
+        typedef const_iterator                                          iterator;
+
+        persistent_vector() noe_std_no_except : m_root(0), m_tail(0), m_size(0), m_offset(0), m_shift(bits) {}
+        persistent_vector(const persistent_vector& rhs) noe_std_no_except;
+        persistent_vector& operator=(const persistent_vector& rhs) noe_std_no_except;
+        persistent_vector(persistent_vector&& rhs) noe_std_no_except;
+        persistent_vector& operator=(persistent_vector&& rhs) noe_std_no_except;
+        ~persistent_vector();
+
+        const_reference operator[](size_type n) const;
+        const_reference front() const { return (*this)[0]; }
+        const_reference back() const { return (*this)[size() - 1]; }
+        const_iterator begin() const { return const_iterator(this, 0); }
+        const_iterator cbegin() const { return const_iterator(this, 0); }
+        const_iterator end() const { return const_iterator(this, size()); }
+        const_iterator cend() const { return const_iterator(this, size()); }
+
+        bool empty() const noe_std_no_except { return m_size == m_offset; }
+        size_type size() const noe_std_no_except { return m_size - m_offset; }
+        void clear() noe_std_no_except;
+        void swap(persistent_vector& other) noe_std_no_except;
+
+        bool push_back(const_reference v);
+        // pop_back and take may have to copy the path to the new last leaf
+        bool pop_back() { return take(size() - 1); }
+        bool set(size_type n, const_reference v);
+        // keeps the first n elements
+        bool take(size_type n);
+        // keeps [first, last)
+        bool slice(size_type first, size_type last);
+        bool append(const persistent_vector& rhs);
+
+    private:
+        size_type tail_offset() const noe_std_no_except { return m_size == 0 ? 0 : ((m_size - 1) >> bits) << bits; }
+        leaf_t* leaf_for(size_type index) const noe_std_no_except;
+
+        static void retain(node_t* node) noe_std_no_except { node->m_refs.fetch_add(1, std::memory_order_relaxed); }
+        static bool unique(const node_t* node) noe_std_no_except { return node->m_refs.load(std::memory_order_acquire) == 1; }
+        static void release(node_t* node, size_type shift);
+        static void destroy_values(leaf_t* leaf, size_type first);
+
+        static bool fill_stash(node_stash& stash, size_type inner, bool leaf);
+        static void drain_stash(node_stash& stash);
+        static inner_t* take_inner(node_stash& stash) noe_std_no_except;
+        static leaf_t* take_leaf(node_stash& stash) noe_std_no_except;
+        static inner_t* editable(node_t* node, size_type shift, node_stash& stash);
+
+        void push_tail(node_stash& stash, leaf_t* leaf);
+        static node_t* push_tail(node_stash& stash, size_type shift, node_t* parent, leaf_t* leaf, size_type offset);
+        static node_t* new_path(node_stash& stash, size_type shift, leaf_t* leaf);
+        static node_t* trim(node_stash& stash, size_type shift, node_t* node, size_type count);
+        static node_t* set_in_tree(node_stash& stash, size_type shift, node_t* node, size_type index, const_reference v);
+        bool push_leaf(leaf_t* leaf);
+
+        node_t*     m_root;     // inner node at level m_shift, 0 while everything fits in the tail
+        leaf_t*     m_tail;
+        size_type   m_size;     // including the m_offset hidden elements
+        size_type   m_offset;   // elements before m_offset were sliced off
+        size_type   m_shift;
+    };
+
+    template<class T, class AllocatorT>
+    persistent_vector<T, AllocatorT>::persistent_vector(const persistent_vector& rhs) noe_std_no_except :
+        m_root(rhs.m_root), m_tail(rhs.m_tail), m_size(rhs.m_size), m_offset(rhs.m_offset), m_shift(rhs.m_shift)
+    {
+        if(m_root)
+            retain(m_root);
+        if(m_tail)
+            retain(m_tail);
+    }
+
+    template<class T, class AllocatorT>
+    persistent_vector<T, AllocatorT>& persistent_vector<T, AllocatorT>::operator=(const persistent_vector& rhs) noe_std_no_except
+    {
+        persistent_vector other(rhs);
+        swap(other);
+        return *this;
+    }
+
+    template<class T, class AllocatorT>
+    persistent_vector<T, AllocatorT>::persistent_vector(persistent_vector&& rhs) noe_std_no_except :
+        m_root(rhs.m_root), m_tail(rhs.m_tail), m_size(rhs.m_size), m_offset(rhs.m_offset), m_shift(rhs.m_shift)
+    {
+        rhs.m_root = 0;
+        rhs.m_tail = 0;
+        rhs.m_size = 0;
+        rhs.m_offset = 0;
+        rhs.m_shift = bits; // transfer ownership
+    }
+
+    template<class T, class AllocatorT>
+    persistent_vector<T, AllocatorT>& persistent_vector<T, AllocatorT>::operator=(persistent_vector&& rhs) noe_std_no_except
+    {
+        swap(rhs);
+        return *this;
+    }
+
+    template<class T, class AllocatorT>
+    persistent_vector<T, AllocatorT>::~persistent_vector()
+    {
+        clear();
+    }
+
+    template<class T, class AllocatorT>
+    typename persistent_vector<T, AllocatorT>::const_reference persistent_vector<T, AllocatorT>::operator[](size_type n) const
+    {
+        size_type index = n + m_offset;
+        if(index >= tail_offset())
+            return m_tail->values()[index - tail_offset()];
+        return leaf_for(index)->values()[index & mask];
+    }
+
+    template<class T, class AllocatorT>
+    void persistent_vector<T, AllocatorT>::clear() noe_std_no_except
+    {
+        if(m_root)
+            release(m_root, m_shift);
+        if(m_tail)
+            release(m_tail, 0);
+        m_root = 0;
+        m_tail = 0;
+        m_size = 0;
+        m_offset = 0;
+        m_shift = bits;
+    }
+
+    template<class T, class AllocatorT>
+    void persistent_vector<T, AllocatorT>::swap(persistent_vector& other) noe_std_no_except
+    {
+        std::swap(m_root, other.m_root);
+        std::swap(m_tail, other.m_tail);
+        std::swap(m_size, other.m_size);
+        std::swap(m_offset, other.m_offset);
+        std::swap(m_shift, other.m_shift);
+    }
+
+    template<class T, class AllocatorT>
+    bool persistent_vector<T, AllocatorT>::push_back(const_reference v)
+    {
+        size_type tail_size = m_size - tail_offset();
+        if(m_tail && tail_size < width) {
+            if(unique(m_tail)) {
+                destroy_values(m_tail, tail_size); // left behind by versions that are gone now
+                ::new(static_cast<void*>(m_tail->values() + tail_size)) T(v);
+                m_tail->m_count.store(tail_size + 1, std::memory_order_relaxed);
+                ++m_size;
+                return true;
+            }
+            // shared tail: the version that matches its constructed prefix claims the next slot,
+            // the other versions never read past their own size
+            size_type expected = tail_size;
+            if(m_tail->m_count.compare_exchange_strong(expected, tail_size + 1, std::memory_order_acq_rel)) {
+                ::new(static_cast<void*>(m_tail->values() + tail_size)) T(v);
+                ++m_size;
+                return true;
+            }
+            leaf_t* leaf = leaf_allocator_t().allocate(1);
+            if(!leaf)
+                return false;
+            leaf->m_refs.store(1, std::memory_order_relaxed);
+            T* values = m_tail->values();
+            for(size_type i = 0; i < tail_size; ++i)
+                ::new(static_cast<void*>(leaf->values() + i)) T(values[i]);
+            ::new(static_cast<void*>(leaf->values() + tail_size)) T(v);
+            leaf->m_count.store(tail_size + 1, std::memory_order_relaxed);
+            release(m_tail, 0);
+            m_tail = leaf;
+            ++m_size;
+            return true;
+        }
+        // the full tail moves into the trie and a new tail starts with v
+        node_stash stash;
+        if(!fill_stash(stash, m_tail ? m_shift / bits + 1 : 0, true))
+            return false;
+        leaf_t* leaf = take_leaf(stash);
+        ::new(static_cast<void*>(leaf->values())) T(v);
+        leaf->m_count.store(1, std::memory_order_relaxed);
+        if(m_tail)
+            push_tail(stash, leaf);
+        else
+            m_tail = leaf;
+        ++m_size;
+        drain_stash(stash);
+        return true;
+    }
+
+    template<class T, class AllocatorT>
+    bool persistent_vector<T, AllocatorT>::set(size_type n, const_reference v)
+    {
+        size_type index = n + m_offset;
+        size_type offset = tail_offset();
+        if(index >= offset) {
+            if(unique(m_tail)) {
+                m_tail->values()[index - offset] = v;
+                return true;
+            }
+            // copy this version's prefix of the tail with v in place
+            node_stash stash;
+            if(!fill_stash(stash, 0, true))
+                return false;
+            leaf_t* leaf = take_leaf(stash);
+            size_type tail_size = m_size - offset;
+            T* values = m_tail->values();
+            for(size_type i = 0; i < tail_size; ++i)
+                ::new(static_cast<void*>(leaf->values() + i)) T(i == index - offset ? v : values[i]);
+            leaf->m_count.store(tail_size, std::memory_order_relaxed);
+            release(m_tail, 0);
+            m_tail = leaf;
+            return true;
+        }
+        // every node below the first shared one on the path has to be copied
+        size_type inner = 0;
+        bool shared = false;
+        node_t* node = m_root;
+        for(size_type shift = m_shift; shift > 0; shift -= bits) {
+            shared = shared || !unique(node);
+            inner += shared;
+            node = static_cast<inner_t*>(node)->m_children[(index >> shift) & mask];
+        }
+        shared = shared || !unique(node);
+        node_stash stash;
+        if(!fill_stash(stash, inner, shared))
+            return false;
+        m_root = set_in_tree(stash, m_shift, m_root, index, v);
+        drain_stash(stash);
+        return true;
+    }
+
+    template<class T, class AllocatorT>
+    bool persistent_vector<T, AllocatorT>::take(size_type n)
+    {
+        if(n >= size())
+            return true;
+        if(n == 0) {
+            clear();
+            return true;
+        }
+        size_type new_size = m_offset + n;
+        size_type new_offset = ((new_size - 1) >> bits) << bits;
+        if(new_offset == tail_offset()) {
+            if(unique(m_tail))
+                destroy_values(m_tail, new_size - new_offset);
+            m_size = new_size;
+            return true;
+        }
+        // the leaf holding the new last element becomes the tail, the trie is cut to the leaves before it
+        node_stash stash;
+        if(!fill_stash(stash, m_shift / bits, false))
+            return false;
+        leaf_t* tail = leaf_for(new_offset);
+        retain(tail);
+        if(new_offset == 0) {
+            release(m_root, m_shift);
+            m_root = 0;
+            m_shift = bits;
+        } else {
+            m_root = trim(stash, m_shift, m_root, new_offset);
+            // drop root levels left with a single child
+            while(m_shift > bits && ((new_offset - 1) >> m_shift) == 0) {
+                node_t* child = static_cast<inner_t*>(m_root)->m_children[0];
+                retain(child);
+                release(m_root, m_shift);
+                m_root = child;
+                m_shift -= bits;
+            }
+        }
+        release(m_tail, 0);
+        m_tail = tail;
+        m_size = new_size;
+        if(unique(m_tail))
+            destroy_values(m_tail, new_size - new_offset);
+        drain_stash(stash);
+        return true;
+    }
+
+    template<class T, class AllocatorT>
+    bool persistent_vector<T, AllocatorT>::slice(size_type first, size_type last)
+    {
+        if(first >= last) {
+            clear();
+            return true;
+        }
+        if(!take(last))
+            return false;
+        m_offset += first;
+        return true;
+    }
+
+    template<class T, class AllocatorT>
+    bool persistent_vector<T, AllocatorT>::append(const persistent_vector& rhs)
+    {
+        // build on a copy, so a failed allocation half way leaves *this untouched (rhs may be *this)
+        persistent_vector result(*this);
+        size_type rhs_tail_offset = rhs.tail_offset();
+        for(size_type index = rhs.m_offset; index < rhs.m_size; ) {
+            if((result.m_size & mask) == 0 && (index & mask) == 0 && index + width <= rhs_tail_offset) {
+                if(!result.push_leaf(rhs.leaf_for(index)))
+                    return false;
+                index += width;
+            } else {
+                if(!result.push_back(rhs[index - rhs.m_offset]))
+                    return false;
+                ++index;
+            }
+        }
+        swap(result);
+        return true;
+    }
+
+    template<class T, class AllocatorT>
+    typename persistent_vector<T, AllocatorT>::leaf_t* persistent_vector<T, AllocatorT>::leaf_for(size_type index) const noe_std_no_except
+    {
+        node_t* node = m_root;
+        for(size_type shift = m_shift; shift > 0; shift -= bits)
+            node = static_cast<inner_t*>(node)->m_children[(index >> shift) & mask];
+        return static_cast<leaf_t*>(node);
+    }
+
+    template<class T, class AllocatorT>
+    void persistent_vector<T, AllocatorT>::release(node_t* node, size_type shift)
+    {
+        if(node->m_refs.fetch_sub(1, std::memory_order_acq_rel) != 1)
+            return;
+        if(shift == 0) {
+            leaf_t* leaf = static_cast<leaf_t*>(node);
+            destroy_values(leaf, 0);
+            leaf_allocator_t().deallocate(leaf, 1);
+            return;
+        }
+        inner_t* inner = static_cast<inner_t*>(node);
+        for(size_type i = 0; i < width && inner->m_children[i]; ++i)
+            release(inner->m_children[i], shift - bits);
+        inner_allocator_t().deallocate(inner, 1);
+    }
+
+    template<class T, class AllocatorT>
+    void persistent_vector<T, AllocatorT>::destroy_values(leaf_t* leaf, size_type first)
+    {
+        size_type count = leaf->m_count.load(std::memory_order_relaxed);
+        for(size_type i = first; i < count; ++i)
+            leaf->values()[i].~T();
+        if(first < count)
+            leaf->m_count.store(first, std::memory_order_relaxed);
+    }
+
+    template<class T, class AllocatorT>
+    bool persistent_vector<T, AllocatorT>::fill_stash(node_stash& stash, size_type inner, bool leaf)
+    {
+        stash.m_inner_count = 0;
+        stash.m_leaf = 0;
+        if(leaf && !(stash.m_leaf = leaf_allocator_t().allocate(1)))
+            return false;
+        for(; stash.m_inner_count < inner; ++stash.m_inner_count) {
+            inner_t* node = inner_allocator_t().allocate(1);
+            if(!node) {
+                drain_stash(stash);
+                return false;
+            }
+            stash.m_inner[stash.m_inner_count] = node;
+        }
+        return true;
+    }
+
+    template<class T, class AllocatorT>
+    void persistent_vector<T, AllocatorT>::drain_stash(node_stash& stash)
+    {
+        while(stash.m_inner_count)
+            inner_allocator_t().deallocate(stash.m_inner[--stash.m_inner_count], 1);
+        if(stash.m_leaf)
+            leaf_allocator_t().deallocate(stash.m_leaf, 1);
+        stash.m_leaf = 0;
+    }
+
+    template<class T, class AllocatorT>
+    inline typename persistent_vector<T, AllocatorT>::inner_t* persistent_vector<T, AllocatorT>::take_inner(node_stash& stash) noe_std_no_except
+    {
+        inner_t* node = stash.m_inner[--stash.m_inner_count];
+        node->m_refs.store(1, std::memory_order_relaxed);
+        for(size_type i = 0; i < width; ++i)
+            node->m_children[i] = 0;
+        return node;
+    }
+
+    template<class T, class AllocatorT>
+    inline typename persistent_vector<T, AllocatorT>::leaf_t* persistent_vector<T, AllocatorT>::take_leaf(node_stash& stash) noe_std_no_except
+    {
+        leaf_t* leaf = stash.m_leaf;
+        stash.m_leaf = 0;
+        leaf->m_refs.store(1, std::memory_order_relaxed);
+        leaf->m_count.store(0, std::memory_order_relaxed);
+        return leaf;
+    }
+
+    template<class T, class AllocatorT>
+    typename persistent_vector<T, AllocatorT>::inner_t* persistent_vector<T, AllocatorT>::editable(node_t* node, size_type shift, node_stash& stash)
+    {
+        // a node only this version references is changed in place, a shared one is copied once
+        if(unique(node))
+            return static_cast<inner_t*>(node);
+        inner_t* copy = take_inner(stash);
+        inner_t* inner = static_cast<inner_t*>(node);
+        for(size_type i = 0; i < width && inner->m_children[i]; ++i) {
+            copy->m_children[i] = inner->m_children[i];
+            retain(copy->m_children[i]);
+        }
+        release(node, shift);
+        return copy;
+    }
+
+    template<class T, class AllocatorT>
+    void persistent_vector<T, AllocatorT>::push_tail(node_stash& stash, leaf_t* leaf)
+    {
+        // m_tail is full and sits at m_size - width, the trie takes over its reference
+        size_type offset = m_size - width;
+        if(!m_root) {
+            inner_t* root = take_inner(stash);
+            root->m_children[0] = m_tail;
+            m_root = root;
+        } else if((m_size >> bits) > (size_type(1) << m_shift)) {
+            inner_t* root = take_inner(stash);
+            root->m_children[0] = m_root;
+            root->m_children[1] = new_path(stash, m_shift, m_tail);
+            m_root = root;
+            m_shift += bits;
+        } else {
+            m_root = push_tail(stash, m_shift, m_root, m_tail, offset);
+        }
+        m_tail = leaf;
+    }
+
+    template<class T, class AllocatorT>
+    typename persistent_vector<T, AllocatorT>::node_t* persistent_vector<T, AllocatorT>::push_tail(node_stash& stash, size_type shift, node_t* parent, leaf_t* leaf, size_type offset)
+    {
+        inner_t* node = editable(parent, shift, stash);
+        size_type slot = (offset >> shift) & mask;
+        if(shift == bits)
+            node->m_children[slot] = leaf;
+        else if(node_t* child = node->m_children[slot])
+            node->m_children[slot] = push_tail(stash, shift - bits, child, leaf, offset);
+        else
+            node->m_children[slot] = new_path(stash, shift - bits, leaf);
+        return node;
+    }
+
+    template<class T, class AllocatorT>
+    typename persistent_vector<T, AllocatorT>::node_t* persistent_vector<T, AllocatorT>::new_path(node_stash& stash, size_type shift, leaf_t* leaf)
+    {
+        if(shift == 0)
+            return leaf;
+        inner_t* node = take_inner(stash);
+        node->m_children[0] = new_path(stash, shift - bits, leaf);
+        return node;
+    }
+
+    template<class T, class AllocatorT>
+    typename persistent_vector<T, AllocatorT>::node_t* persistent_vector<T, AllocatorT>::trim(node_stash& stash, size_type shift, node_t* node, size_type count)
+    {
+        // keeps the first count (> 0, a multiple of width) elements below node
+        inner_t* inner = editable(node, shift, stash);
+        size_type keep = ((count - 1) >> shift) + 1;
+        for(size_type i = keep; i < width && inner->m_children[i]; ++i) {
+            release(inner->m_children[i], shift - bits);
+            inner->m_children[i] = 0;
+        }
+        if(shift > bits)
+            inner->m_children[keep - 1] = trim(stash, shift - bits, inner->m_children[keep - 1], count - ((keep - 1) << shift));
+        return inner;
+    }
+
+    template<class T, class AllocatorT>
+    typename persistent_vector<T, AllocatorT>::node_t* persistent_vector<T, AllocatorT>::set_in_tree(node_stash& stash, size_type shift, node_t* node, size_type index, const_reference v)
+    {
+        inner_t* inner = editable(node, shift, stash);
+        size_type slot = (index >> shift) & mask;
+        node_t* child = inner->m_children[slot];
+        if(shift > bits) {
+            inner->m_children[slot] = set_in_tree(stash, shift - bits, child, index, v);
+            return inner;
+        }
+        leaf_t* leaf = static_cast<leaf_t*>(child);
+        if(unique(leaf)) {
+            leaf->values()[index & mask] = v;
+            return inner;
+        }
+        // copy with v in place before letting go of the old leaf, v may live in it
+        leaf_t* copy = take_leaf(stash);
+        for(size_type i = 0; i < width; ++i)
+            ::new(static_cast<void*>(copy->values() + i)) T(i == (index & mask) ? v : leaf->values()[i]);
+        copy->m_count.store(width, std::memory_order_relaxed);
+        inner->m_children[slot] = copy;
+        release(leaf, 0);
+        return inner;
+    }
+
+    template<class T, class AllocatorT>
+    bool persistent_vector<T, AllocatorT>::push_leaf(leaf_t* leaf)
+    {
+        // m_size is on a leaf boundary, leaf is full and becomes the new tail unchanged
+        retain(leaf);
+        if(!m_tail) {
+            m_tail = leaf;
+            m_size = width;
+            return true;
+        }
+        node_stash stash;
+        if(!fill_stash(stash, m_shift / bits + 1, false)) {
+            release(leaf, 0);
+            return false;
+        }
+        push_tail(stash, leaf);
+        m_size += width;
+        drain_stash(stash);
+        return true;
+    }
+}
+
+#endif // GUARD_NOE_STD_persistent_vector_H
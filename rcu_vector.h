@@ -0,0 +1,278 @@
+/**
+ * NoException Standard Library Container Implementation
+ * by Marvin Manese 2017
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+#ifndef GUARD_NOE_STD_rcu_vector_H
+#define GUARD_NOE_STD_rcu_vector_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <utility>
+#include "allocator.h"
+#include "macro.h"
+#include "vector.h"
+
+namespace noe_std
+{
+namespace detail
+{
+    /// Reader slot of the calling thread, threads are spread round robin over the slots
+    inline std::size_t rcu_thread_slot(std::size_t slot_count) noe_std_no_except
+    {
+        static std::atomic<std::size_t> next_thread(0);
+        static thread_local std::size_t thread_index = next_thread.fetch_add(1, std::memory_order_relaxed);
+        return thread_index % slot_count;
+    }
+
+    /// Readers active in each epoch parity, on its own cache line so reader threads mapped to
+    /// different slots never write to the same line
+    struct alignas(64) rcu_reader_slot
+    {
+        std::atomic<std::size_t> m_active[2];
+    };
+}
+    /// Read mostly vector with wait free readers: read() pins the current snapshot with one counter
+    /// increment on the thread's own cache line plus one atomic load and never blocks a writer.
+    /// Writers build a complete new vector and publish it with one atomic exchange, the old snapshot
+    /// is retired and freed once no reader can still see it (epoch based reclamation): a retired
+    /// snapshot is freed after the epoch advanced twice, and the epoch only advances while no reader
+    /// is left in the previous one. Writers are serialized by a mutex, readers never take it.
+    /// Snapshots are immutable, so references obtained through a read_guard stay valid while it lives.
+    /// Destruction must not race with readers or writers.
+    template<class T,
+             class AllocatorT = allocator<T>,
+             std::size_t ReaderSlots = 64>
+    class rcu_vector
+    {
+    public:
+        typedef T                                   value_type;
+        typedef vector<T, AllocatorT>               vector_type;
+        typedef std::size_t                         size_type;
+        typedef const T&                            const_reference;
+        typedef const T*                            const_pointer;
+        typedef const T*                            const_iterator;
+
+    private:
+        struct snapshot
+        {
+            vector_type     m_data;
+            std::uint64_t   m_retired_at;
+            snapshot*       m_next;     // retired list
+        };
+
+        typedef typename AllocatorT::template rebind<snapshot>::other snapshot_allocator_t;
+
+    public:
+        /// Pins one snapshot for as long as it lives, movable but not copyable
+        class read_guard
+        {
+        public:
+            read_guard(read_guard&& rhs) noe_std_no_except : m_snapshot(rhs.m_snapshot), m_counter(rhs.m_counter) { rhs.m_counter = 0; }
+            ~read_guard() { if(m_counter) m_counter->fetch_sub(1, std::memory_order_release); }
+
+            const vector_type* get() const noe_std_no_except { return m_snapshot ? &m_snapshot->m_data : 0; }
+            size_type size() const noe_std_no_except { return m_snapshot ? m_snapshot->m_data.size() : 0; }
+            bool empty() const noe_std_no_except { return size() == 0; }
+            const_pointer data() const noe_std_no_except { return m_snapshot ? m_snapshot->m_data.data() : 0; }
+            const_reference operator[](size_type n) const { return m_snapshot->m_data[n]; }
+            const_iterator begin() const noe_std_no_except { return data(); }
+            const_iterator end() const noe_std_no_except { return data() + size(); }
+
+        private:
+            friend class rcu_vector;
+            read_guard(const snapshot* s, std::atomic<size_type>* counter) noe_std_no_except : m_snapshot(s), m_counter(counter) {}
+            read_guard(const read_guard&);
+            read_guard& operator=(const read_guard&);
+
+            const snapshot*             m_snapshot;
+            std::atomic<size_type>*     m_counter;
+        };
+
+        rcu_vector() noe_std_no_except;
+        ~rcu_vector();
+
+        read_guard read() const noe_std_no_except;
+        /// Publishes next as the new contents (next is left empty),
+        /// false if the snapshot could not be allocated, in which case next is untouched
+        bool publish(vector_type&& next);
+        /// Copies the current contents, lets fn(vector_type&) edit the copy and publishes it if fn returns true;
+        /// false if the copy could not be made or fn declined
+        template<class Fn> bool update(Fn fn);
+        /// Frees the retired snapshots no reader can see anymore, returns how many are still pending
+        size_type reclaim();
+
+    private:
+        rcu_vector(const rcu_vector&);
+        rcu_vector& operator=(const rcu_vector&);
+
+        bool publish_locked(vector_type& next);
+        bool try_advance() noe_std_no_except;
+        size_type reclaim_locked();
+        void free_snapshot(snapshot* s);
+
+        detail::rcu_reader_slot                 m_slots[ReaderSlots];
+        alignas(64) std::atomic<snapshot*>      m_current;
+        std::atomic<std::uint64_t>              m_epoch;
+        alignas(64) std::mutex                  m_write_mutex;
+        snapshot*                               m_retired;  // newest first, guarded by m_write_mutex
+    };
+
+    template<class T, class AllocatorT, std::size_t ReaderSlots>
+    rcu_vector<T, AllocatorT, ReaderSlots>::rcu_vector() noe_std_no_except :
+        m_current(0), m_epoch(0), m_retired(0)
+    {
+        for(size_type i = 0; i < ReaderSlots; ++i) {
+            m_slots[i].m_active[0].store(0, std::memory_order_relaxed);
+            m_slots[i].m_active[1].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    template<class T, class AllocatorT, std::size_t ReaderSlots>
+    rcu_vector<T, AllocatorT, ReaderSlots>::~rcu_vector()
+    {
+        while(m_retired) {
+            snapshot* next = m_retired->m_next;
+            free_snapshot(m_retired);
+            m_retired = next;
+        }
+        if(snapshot* current = m_current.load(std::memory_order_relaxed))
+            free_snapshot(current);
+    }
+
+    template<class T, class AllocatorT, std::size_t ReaderSlots>
+    typename rcu_vector<T, AllocatorT, ReaderSlots>::read_guard rcu_vector<T, AllocatorT, ReaderSlots>::read() const noe_std_no_except
+    {
+        // announce the reader before loading the snapshot, a writer that misses the announcement
+        // has already published a newer snapshot and this load sees that one (all seq_cst)
+        std::uint64_t epoch = m_epoch.load();
+        std::atomic<size_type>* counter = const_cast<std::atomic<size_type>*>(&m_slots[detail::rcu_thread_slot(ReaderSlots)].m_active[epoch & 1]);
+        counter->fetch_add(1);
+        return read_guard(m_current.load(), counter);
+    }
+
+    template<class T, class AllocatorT, std::size_t ReaderSlots>
+    bool rcu_vector<T, AllocatorT, ReaderSlots>::publish(vector_type&& next)
+    {
+        std::lock_guard<std::mutex> lock(m_write_mutex);
+        return publish_locked(next);
+    }
+
+    template<class T, class AllocatorT, std::size_t ReaderSlots>
+    template<class Fn>
+    bool rcu_vector<T, AllocatorT, ReaderSlots>::update(Fn fn)
+    {
+        std::lock_guard<std::mutex> lock(m_write_mutex);
+        // writers hold the mutex, so the current snapshot can not be retired under us
+        const snapshot* current = m_current.load(std::memory_order_acquire);
+        vector_type next;
+        if(current) {
+            vector_type copy(current->m_data);
+            if(copy.size() != current->m_data.size())
+                return false;
+            next.swap(copy);
+        }
+        if(!fn(next))
+            return false;
+        return publish_locked(next);
+    }
+
+    template<class T, class AllocatorT, std::size_t ReaderSlots>
+    typename rcu_vector<T, AllocatorT, ReaderSlots>::size_type rcu_vector<T, AllocatorT, ReaderSlots>::reclaim()
+    {
+        std::lock_guard<std::mutex> lock(m_write_mutex);
+        return reclaim_locked();
+    }
+
+    template<class T, class AllocatorT, std::size_t ReaderSlots>
+    bool rcu_vector<T, AllocatorT, ReaderSlots>::publish_locked(vector_type& next)
+    {
+        snapshot_allocator_t alloc;
+        snapshot* s = alloc.allocate(1);
+        if(!s)
+            return false;
+        ::new(static_cast<void*>(s)) snapshot();
+        s->m_data.swap(next);
+        s->m_retired_at = 0;
+        s->m_next = 0;
+
+        snapshot* old = m_current.exchange(s);
+        if(old) {
+            old->m_retired_at = m_epoch.load();
+            old->m_next = m_retired;
+            m_retired = old;
+        }
+        reclaim_locked();
+        return true;
+    }
+
+    template<class T, class AllocatorT, std::size_t ReaderSlots>
+    bool rcu_vector<T, AllocatorT, ReaderSlots>::try_advance() noe_std_no_except
+    {
+        // readers still counted in the previous epoch (same parity as the next one) hold the epoch back
+        std::uint64_t epoch = m_epoch.load();
+        std::size_t previous = (epoch + 1) & 1;
+        for(size_type i = 0; i < ReaderSlots; ++i) {
+            if(m_slots[i].m_active[previous].load() != 0)
+                return false;
+        }
+        m_epoch.store(epoch + 1);
+        return true;
+    }
+
+    template<class T, class AllocatorT, std::size_t ReaderSlots>
+    typename rcu_vector<T, AllocatorT, ReaderSlots>::size_type rcu_vector<T, AllocatorT, ReaderSlots>::reclaim_locked()
+    {
+        if(!m_retired)
+            return 0;
+        // the newest snapshot needs the most advances, two past its retirement frees everything
+        for(int i = 0; i < 2 && m_epoch.load() < m_retired->m_retired_at + 2; ++i) {
+            if(!try_advance())
+                break;
+        }
+        std::uint64_t epoch = m_epoch.load();
+        size_type pending = 0;
+        snapshot** link = &m_retired;
+        while(*link) {
+            snapshot* s = *link;
+            if(epoch >= s->m_retired_at + 2) {
+                *link = s->m_next;
+                free_snapshot(s);
+            } else {
+                link = &s->m_next;
+                ++pending;
+            }
+        }
+        return pending;
+    }
+
+    template<class T, class AllocatorT, std::size_t ReaderSlots>
+    void rcu_vector<T, AllocatorT, ReaderSlots>::free_snapshot(snapshot* s)
+    {
+        snapshot_allocator_t alloc;
+        s->~snapshot();
+        alloc.deallocate(s, 1);
+    }
+}
+
+#endif // GUARD_NOE_STD_rcu_vector_H
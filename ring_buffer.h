@@ -0,0 +1,456 @@
+/**
+ * NoException Standard Library Container Implementation
+ * by Marvin Manese 2017
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+#ifndef GUARD_NOE_STD_ring_buffer_H
+#define GUARD_NOE_STD_ring_buffer_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include "allocator.h"
+#include "macro.h"
+#include "type_traits.h"
+#include "detail/indexed_iterator.h"
+
+namespace noe_std
+{
+namespace detail
+{
+    /// Same shape as vector_allocator_holder, the impl additionally tracks where the ring starts
+    /// and its destructor walks the (possibly wrapped) elements before releasing the block
+    template<class AllocatorT>
+    struct ring_buffer_allocator_holder
+    {
+        typedef AllocatorT                                  allocator_type;
+        typedef std::allocator_traits<allocator_type>       alloc_traits_t;
+        typedef typename alloc_traits_t::value_type         value_type;
+        typedef typename alloc_traits_t::size_type          size_type;
+        typedef typename alloc_traits_t::difference_type    difference_type;
+        typedef value_type&                                 reference;
+        typedef const value_type&                           const_reference;
+        typedef typename alloc_traits_t::pointer            pointer;
+        typedef typename alloc_traits_t::const_pointer      const_pointer;
+
+        ring_buffer_allocator_holder() {}
+        ring_buffer_allocator_holder(const ring_buffer_allocator_holder& rhs) = delete;
+        ring_buffer_allocator_holder& operator=(const ring_buffer_allocator_holder& rhs) = delete;
+        ring_buffer_allocator_holder(ring_buffer_allocator_holder&& rhs) = default;
+        ring_buffer_allocator_holder& operator=(ring_buffer_allocator_holder&& rhs) = default;
+        ring_buffer_allocator_holder(const allocator_type& alloc) : m_member(alloc) {}
+        ring_buffer_allocator_holder(const allocator_type& alloc, size_type n) : m_member(alloc, n) {}
+
+        struct ring_buffer_impl : public allocator_type
+        {
+            ring_buffer_impl() : m_capacity(0), m_head(0), m_size(0), m_data(0) {}
+            ring_buffer_impl(const ring_buffer_impl& rhs) = delete;
+            ring_buffer_impl& operator=(const ring_buffer_impl& rhs) = delete;
+            ring_buffer_impl(ring_buffer_impl&& rhs) = default;
+            ring_buffer_impl& operator=(ring_buffer_impl&& rhs) = default;
+            ~ring_buffer_impl()
+            {
+                if(m_data) {
+                    while(m_size)
+                        allocator_type::destroy(m_data + ((m_head + (--m_size)) & (m_capacity - 1)));
+                    allocator_type::deallocate(m_data, m_capacity);
+                }
+            }
+
+            ring_buffer_impl(const allocator_type& alloc) : allocator_type(alloc), m_capacity(0), m_head(0), m_size(0), m_data(0) {}
+            ring_buffer_impl(const allocator_type& alloc, size_type n) : allocator_type(alloc), m_capacity(0), m_head(0), m_size(0), m_data(0) { allocate(n); }
+
+            // n is a power of two, allocate_at_least is not used since extra slots would break the mask
+            void allocate(size_type n)
+            {
+                if(n > 0) {
+                    m_data = allocator_type::allocate(n);
+                    m_capacity = m_data ? n : 0;
+                }
+            }
+
+            void swap(ring_buffer_impl& other) noe_std_no_except
+            {
+                std::swap(m_capacity, other.m_capacity);
+                std::swap(m_head, other.m_head);
+                std::swap(m_size, other.m_size);
+                std::swap(m_data, other.m_data);
+            }
+
+            size_type   m_capacity; // zero or a power of two
+            size_type   m_head;     // slot of the front element
+            size_type   m_size;
+            pointer     m_data;
+        } m_member;
+
+        allocator_type& allocator() { return m_member; }
+        const allocator_type& allocator() const { return m_member; }
+    };
+
+    /// Smallest power of two holding n elements, 0 for 0
+    inline std::size_t ring_buffer_capacity(std::size_t n, std::size_t min_capacity) noe_std_no_except
+    {
+        if(n == 0)
+            return 0;
+        std::size_t capacity = min_capacity;
+        while(capacity < n)
+            capacity *= 2;
+        return capacity;
+    }
+}
+    /// Growable circular buffer: push and pop at both ends are O(1) and never shift elements.
+    /// The capacity is a power of two so a logical index maps to its slot with a mask, growing
+    /// relocates once into a twice as large block and unwraps the elements to its start on the way.
+    /// first_span / second_span expose the (at most two) contiguous runs in order for bulk I/O.
+    /// Like vector, insertions return false (and leave the buffer untouched) if allocation fails.
+    template<class T, class AllocatorT = allocator<T> >
+    class ring_buffer : protected detail::ring_buffer_allocator_holder<AllocatorT>
+    {
+    private:
+        typedef detail::ring_buffer_allocator_holder<AllocatorT>                        base_t;
+        typedef typename base_t::ring_buffer_impl                                       impl_t;
+        typedef std::integral_constant<bool, is_trivially_relocatable<T>::value>        trivially_relocatable_t;
+        typedef std::integral_constant<bool, std::is_trivially_copyable<T>::value>      trivially_copyable_t;
+
+    public:
+        typedef typename base_t::allocator_type     allocator_type;
+        typedef typename base_t::value_type         value_type;
+        typedef typename base_t::size_type          size_type;
+        typedef typename base_t::difference_type    difference_type;
+        typedef typename base_t::reference          reference;
+        typedef typename base_t::const_reference    const_reference;
+        typedef typename base_t::pointer            pointer;
+        typedef typename base_t::const_pointer      const_pointer;
+        typedef detail::indexed_iterator<ring_buffer, reference, pointer>                       iterator;
+        typedef detail::indexed_iterator<const ring_buffer, const_reference, const_pointer>     const_iterator;
+
+        enum : size_type { min_capacity = 8 };
+
+        ring_buffer() {}
+        ring_buffer(const ring_buffer& rhs);
+        ring_buffer& operator=(const ring_buffer& rhs);
+        ring_buffer(ring_buffer&& rhs);
+        ring_buffer& operator=(ring_buffer&& rhs);
+
+        reference operator[](size_type n) { return this->m_member.m_data[slot(n)]; }
+        const_reference operator[](size_type n) const { return this->m_member.m_data[slot(n)]; }
+        reference front() { return (*this)[0]; }
+        const_reference front() const { return (*this)[0]; }
+        reference back() { return (*this)[size() - 1]; }
+        const_reference back() const { return (*this)[size() - 1]; }
+
+        iterator begin() { return iterator(this, 0); }
+        const_iterator begin() const { return const_iterator(this, 0); }
+        const_iterator cbegin() const { return const_iterator(this, 0); }
+        iterator end() { return iterator(this, size()); }
+        const_iterator end() const { return const_iterator(this, size()); }
+        const_iterator cend() const { return const_iterator(this, size()); }
+
+        bool empty() const noe_std_no_except { return this->m_member.m_size == 0; }
+        size_type size() const noe_std_no_except { return this->m_member.m_size; }
+        size_type capacity() const noe_std_no_except { return this->m_member.m_capacity; }
+        size_type max_size() const noe_std_no_except { return this->allocator().max_size(); }
+        bool reserve(size_type n);
+        void shrink_to_fit();
+        void clear();
+        void swap(ring_buffer& other) noe_std_no_except { this->m_member.swap(other.m_member); }
+
+        bool push_back(const_reference v) { return emplace_back(v); }
+        bool push_back(value_type&& v) { return emplace_back(std::move(v)); }
+        bool push_front(const_reference v) { return emplace_front(v); }
+        bool push_front(value_type&& v) { return emplace_front(std::move(v)); }
+        template<class... Args> bool emplace_back(Args&&... args);
+        template<class... Args> bool emplace_front(Args&&... args);
+        void pop_back();
+        void pop_front();
+
+        // the elements in order as at most two contiguous runs, second is empty unless the ring wraps
+        std::pair<pointer, size_type> first_span() noe_std_no_except;
+        std::pair<pointer, size_type> second_span() noe_std_no_except;
+        std::pair<const_pointer, size_type> first_span() const noe_std_no_except;
+        std::pair<const_pointer, size_type> second_span() const noe_std_no_except;
+        // copies n elements to the back in at most two block copies, src must not point into the buffer
+        bool append(const_pointer src, size_type n);
+        // moves up to n elements from the front to dst and pops them, returns how many were moved
+        size_type consume(pointer dst, size_type n);
+
+    private:
+        size_type slot(size_type n) const noe_std_no_except { return (this->m_member.m_head + n) & (this->m_member.m_capacity - 1); }
+        size_type next_capacity(size_type required) const { return detail::ring_buffer_capacity(required, min_capacity); }
+        size_type first_run() const noe_std_no_except;
+        bool relocate(size_type new_capacity);
+        void relocate_data(impl_t& dest, std::true_type);
+        void relocate_data(impl_t& dest, std::false_type);
+        void copy_range(pointer dest, const_pointer src, size_type n, std::true_type);
+        void copy_range(pointer dest, const_pointer src, size_type n, std::false_type);
+        void move_range(pointer dest, pointer src, size_type n, std::true_type);
+        void move_range(pointer dest, pointer src, size_type n, std::false_type);
+    };
+
+    template<class T, class AllocatorT>
+    ring_buffer<T, AllocatorT>::ring_buffer(const ring_buffer& rhs) :
+        base_t(AllocatorT(), detail::ring_buffer_capacity(rhs.size(), min_capacity))
+    {
+        if(this->m_member.m_data) { // allocation success / rhs has data?
+            std::pair<const_pointer, size_type> first = rhs.first_span();
+            std::pair<const_pointer, size_type> second = rhs.second_span();
+            copy_range(this->m_member.m_data, first.first, first.second, trivially_copyable_t());
+            copy_range(this->m_member.m_data + first.second, second.first, second.second, trivially_copyable_t());
+            this->m_member.m_size = rhs.size();
+        }
+    }
+
+    template<class T, class AllocatorT>
+    ring_buffer<T, AllocatorT>& ring_buffer<T, AllocatorT>::operator=(const ring_buffer& rhs)
+    {
+        ring_buffer other(rhs);
+        swap(other);
+        return *this;
+    }
+
+    template<class T, class AllocatorT>
+    ring_buffer<T, AllocatorT>::ring_buffer(ring_buffer&& rhs) :
+        base_t(std::move(rhs))
+    {
+        rhs.m_member.m_capacity = 0;
+        rhs.m_member.m_head = 0;
+        rhs.m_member.m_size = 0;
+        rhs.m_member.m_data = 0; // transfer ownership
+    }
+
+    template<class T, class AllocatorT>
+    ring_buffer<T, AllocatorT>& ring_buffer<T, AllocatorT>::operator=(ring_buffer&& rhs)
+    {
+        swap(rhs);
+        return *this;
+    }
+
+    template<class T, class AllocatorT>
+    bool ring_buffer<T, AllocatorT>::reserve(size_type n)
+    {
+        if(n <= capacity())
+            return true;
+        return relocate(next_capacity(n));
+    }
+
+    template<class T, class AllocatorT>
+    void ring_buffer<T, AllocatorT>::shrink_to_fit()
+    {
+        size_type new_capacity = next_capacity(size());
+        if(new_capacity < capacity())
+            relocate(new_capacity);
+    }
+
+    template<class T, class AllocatorT>
+    void ring_buffer<T, AllocatorT>::clear()
+    {
+        while(this->m_member.m_size)
+            pop_back();
+        this->m_member.m_head = 0;
+    }
+
+    template<class T, class AllocatorT>
+    template<class... Args>
+    bool ring_buffer<T, AllocatorT>::emplace_back(Args&&... args)
+    {
+        size_type size = this->m_member.m_size;
+        if(size < capacity()) {
+            this->allocator().construct(this->m_member.m_data + slot(size), std::forward<Args>(args)...);
+            ++this->m_member.m_size;
+            return true;
+        }
+        // construct the new element before relocating, args may refer to an element of this buffer
+        impl_t tmp(this->allocator(), next_capacity(size + 1));
+        if(!tmp.m_data)
+            return false;
+        this->allocator().construct(tmp.m_data + size, std::forward<Args>(args)...);
+        relocate_data(tmp, trivially_relocatable_t());
+        ++tmp.m_size;
+        tmp.swap(this->m_member); // tmp now owns the old buffer and releases it
+        return true;
+    }
+
+    template<class T, class AllocatorT>
+    template<class... Args>
+    bool ring_buffer<T, AllocatorT>::emplace_front(Args&&... args)
+    {
+        size_type size = this->m_member.m_size;
+        if(size < capacity()) {
+            size_type head = slot(capacity() - 1);
+            this->allocator().construct(this->m_member.m_data + head, std::forward<Args>(args)...);
+            this->m_member.m_head = head;
+            ++this->m_member.m_size;
+            return true;
+        }
+        impl_t tmp(this->allocator(), next_capacity(size + 1));
+        if(!tmp.m_data)
+            return false;
+        this->allocator().construct(tmp.m_data + tmp.m_capacity - 1, std::forward<Args>(args)...);
+        relocate_data(tmp, trivially_relocatable_t());
+        tmp.m_head = tmp.m_capacity - 1;
+        ++tmp.m_size;
+        tmp.swap(this->m_member);
+        return true;
+    }
+
+    template<class T, class AllocatorT>
+    void ring_buffer<T, AllocatorT>::pop_back()
+    {
+        --this->m_member.m_size;
+        this->allocator().destroy(this->m_member.m_data + slot(this->m_member.m_size));
+    }
+
+    template<class T, class AllocatorT>
+    void ring_buffer<T, AllocatorT>::pop_front()
+    {
+        this->allocator().destroy(this->m_member.m_data + this->m_member.m_head);
+        this->m_member.m_head = slot(1);
+        --this->m_member.m_size;
+    }
+
+    template<class T, class AllocatorT>
+    inline std::pair<typename ring_buffer<T, AllocatorT>::pointer, typename ring_buffer<T, AllocatorT>::size_type> ring_buffer<T, AllocatorT>::first_span() noe_std_no_except
+    {
+        return std::make_pair(this->m_member.m_data + this->m_member.m_head, first_run());
+    }
+
+    template<class T, class AllocatorT>
+    inline std::pair<typename ring_buffer<T, AllocatorT>::pointer, typename ring_buffer<T, AllocatorT>::size_type> ring_buffer<T, AllocatorT>::second_span() noe_std_no_except
+    {
+        return std::make_pair(this->m_member.m_data, size() - first_run());
+    }
+
+    template<class T, class AllocatorT>
+    inline std::pair<typename ring_buffer<T, AllocatorT>::const_pointer, typename ring_buffer<T, AllocatorT>::size_type> ring_buffer<T, AllocatorT>::first_span() const noe_std_no_except
+    {
+        return std::make_pair(const_pointer(this->m_member.m_data + this->m_member.m_head), first_run());
+    }
+
+    template<class T, class AllocatorT>
+    inline std::pair<typename ring_buffer<T, AllocatorT>::const_pointer, typename ring_buffer<T, AllocatorT>::size_type> ring_buffer<T, AllocatorT>::second_span() const noe_std_no_except
+    {
+        return std::make_pair(const_pointer(this->m_member.m_data), size() - first_run());
+    }
+
+    template<class T, class AllocatorT>
+    bool ring_buffer<T, AllocatorT>::append(const_pointer src, size_type n)
+    {
+        if(!reserve(size() + n))
+            return false;
+        size_type tail = slot(size());
+        size_type first = std::min(n, capacity() - tail);
+        copy_range(this->m_member.m_data + tail, src, first, trivially_copyable_t());
+        copy_range(this->m_member.m_data, src + first, n - first, trivially_copyable_t());
+        this->m_member.m_size += n;
+        return true;
+    }
+
+    template<class T, class AllocatorT>
+    typename ring_buffer<T, AllocatorT>::size_type ring_buffer<T, AllocatorT>::consume(pointer dst, size_type n)
+    {
+        n = std::min(n, size());
+        size_type first = std::min(n, first_run());
+        move_range(dst, this->m_member.m_data + this->m_member.m_head, first, trivially_copyable_t());
+        move_range(dst + first, this->m_member.m_data, n - first, trivially_copyable_t());
+        for(size_type i = 0; i < n; ++i)
+            pop_front();
+        if(empty())
+            this->m_member.m_head = 0;
+        return n;
+    }
+
+    template<class T, class AllocatorT>
+    inline typename ring_buffer<T, AllocatorT>::size_type ring_buffer<T, AllocatorT>::first_run() const noe_std_no_except
+    {
+        return std::min(size(), capacity() - this->m_member.m_head);
+    }
+
+    template<class T, class AllocatorT>
+    bool ring_buffer<T, AllocatorT>::relocate(size_type new_capacity)
+    {
+        impl_t tmp(this->allocator(), new_capacity);
+        if(new_capacity && !tmp.m_data)
+            return false;
+        relocate_data(tmp, trivially_relocatable_t());
+        tmp.swap(this->m_member);
+        return true;
+    }
+
+    template<class T, class AllocatorT>
+    void ring_buffer<T, AllocatorT>::relocate_data(impl_t& dest, std::true_type)
+    {
+        // unwrap into the start of dest with at most two block copies
+        size_type first = first_run();
+        size_type size = this->m_member.m_size;
+        if(first > 0)
+            std::memcpy(static_cast<void*>(dest.m_data), static_cast<const void*>(this->m_member.m_data + this->m_member.m_head), first * sizeof(value_type));
+        if(size > first)
+            std::memcpy(static_cast<void*>(dest.m_data + first), static_cast<const void*>(this->m_member.m_data), (size - first) * sizeof(value_type));
+        dest.m_head = 0;
+        dest.m_size = size;
+        this->m_member.m_size = 0; // objects now live in dest, old storage must not be destroyed
+    }
+
+    template<class T, class AllocatorT>
+    void ring_buffer<T, AllocatorT>::relocate_data(impl_t& dest, std::false_type)
+    {
+        // moved from elements stay counted here and are destroyed with the old block
+        size_type size = this->m_member.m_size;
+        dest.m_head = 0;
+        while(dest.m_size < size) {
+            size_type dest_size = dest.m_size;
+            this->allocator().construct(dest.m_data + dest_size, std::move_if_noexcept(this->m_member.m_data[slot(dest_size)]));
+            ++dest.m_size;
+        }
+    }
+
+    template<class T, class AllocatorT>
+    inline void ring_buffer<T, AllocatorT>::copy_range(pointer dest, const_pointer src, size_type n, std::true_type)
+    {
+        if(n > 0)
+            std::memcpy(static_cast<void*>(dest), static_cast<const void*>(src), n * sizeof(value_type));
+    }
+
+    template<class T, class AllocatorT>
+    void ring_buffer<T, AllocatorT>::copy_range(pointer dest, const_pointer src, size_type n, std::false_type)
+    {
+        for(size_type i = 0; i < n; ++i)
+            this->allocator().construct(dest + i, src[i]);
+    }
+
+    template<class T, class AllocatorT>
+    inline void ring_buffer<T, AllocatorT>::move_range(pointer dest, pointer src, size_type n, std::true_type)
+    {
+        if(n > 0)
+            std::memcpy(static_cast<void*>(dest), static_cast<const void*>(src), n * sizeof(value_type));
+    }
+
+    template<class T, class AllocatorT>
+    inline void ring_buffer<T, AllocatorT>::move_range(pointer dest, pointer src, size_type n, std::false_type)
+    {
+        std::move(src, src + n, dest);
+    }
+}
+
+#endif // GUARD_NOE_STD_ring_buffer_H
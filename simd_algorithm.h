@@ -0,0 +1,731 @@
+/**
+ * NoException Standard Library Container Implementation
+ * by Marvin Manese 2017
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+#ifndef GUARD_NOE_STD_simd_algorithm_H
+#define GUARD_NOE_STD_simd_algorithm_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include "macro.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__)) && !defined(NOE_STD_NO_SIMD)
+#define NOE_STD_SIMD_X86
+#include <immintrin.h>
+#endif // x86 with GCC / Clang
+
+/// Search and comparison kernels over contiguous arrays of arithmetic types.
+/// On x86 the SSE2 or AVX2 version is picked at runtime from cpuid, everywhere else
+/// (or with NOE_STD_NO_SIMD defined) a portable scalar loop is used.
+/// Results match the scalar algorithms, including NaN and signed zero handling for floats.
+namespace noe_std
+{
+namespace simd
+{
+    /// Types the kernels accept, long double is left out since its padding bytes are unspecified
+    template<class T>
+    struct is_vectorizable
+    {
+        enum : bool { value = std::is_arithmetic<T>::value &&
+                              (std::is_same<T, float>::value || std::is_same<T, double>::value ||
+                               (std::is_integral<T>::value && (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8))) };
+    };
+
+    enum compare_result
+    {
+        compare_less,
+        compare_equal,
+        compare_greater,
+        compare_unordered   // same length and no element decided the order, but some pair was unordered (NaN)
+    };
+
+    template<class T> bool equal(const T* a, const T* b, std::size_t n) noe_std_no_except;
+    template<class T> compare_result compare(const T* a, std::size_t a_size, const T* b, std::size_t b_size) noe_std_no_except;
+    template<class T> std::size_t find(const T* data, std::size_t n, T value) noe_std_no_except;
+    template<class T> std::size_t count(const T* data, std::size_t n, T value) noe_std_no_except;
+    template<class T> bool contains(const T* data, std::size_t n, T value) noe_std_no_except;
+    template<class T> std::size_t min_element(const T* data, std::size_t n) noe_std_no_except;
+    template<class T> std::size_t max_element(const T* data, std::size_t n) noe_std_no_except;
+
+    /// Bit kernels over arrays of 64 bit words, dst and src may be the same array but must not partially overlap
+    inline std::size_t popcount(const std::uint64_t* words, std::size_t n) noe_std_no_except;
+    inline void bit_and(std::uint64_t* dst, const std::uint64_t* src, std::size_t n) noe_std_no_except;
+    inline void bit_or(std::uint64_t* dst, const std::uint64_t* src, std::size_t n) noe_std_no_except;
+    inline void bit_xor(std::uint64_t* dst, const std::uint64_t* src, std::size_t n) noe_std_no_except;
+    inline void bit_andnot(std::uint64_t* dst, const std::uint64_t* src, std::size_t n) noe_std_no_except;  // dst &= ~src
+    /// Unpacks n fields of width bits (0 to 64) stored back to back from bit first_bit of words,
+    /// words must be followed by one readable padding word
+    inline void unpack_bits(const std::uint64_t* words, std::size_t first_bit, unsigned width, std::size_t n, std::uint64_t* out) noe_std_no_except;
+}
+namespace detail
+{
+    enum simd_isa
+    {
+        simd_isa_scalar,
+        simd_isa_sse2,
+        simd_isa_avx2
+    };
+
+    inline simd_isa simd_detect_isa() noe_std_no_except
+    {
+#ifdef NOE_STD_SIMD_X86
+        __builtin_cpu_init();
+        if(__builtin_cpu_supports("avx2"))
+            return simd_isa_avx2;
+        if(__builtin_cpu_supports("sse2"))
+            return simd_isa_sse2;
+#endif // NOE_STD_SIMD_X86
+        return simd_isa_scalar;
+    }
+
+    inline simd_isa simd_current_isa() noe_std_no_except
+    {
+        static const simd_isa isa = simd_detect_isa();
+        return isa;
+    }
+
+    inline bool simd_has_popcnt() noe_std_no_except
+    {
+#ifdef NOE_STD_SIMD_X86
+        static const bool popcnt = (__builtin_cpu_init(), __builtin_cpu_supports("popcnt") != 0);
+        return popcnt;
+#else
+        return false;
+#endif // NOE_STD_SIMD_X86
+    }
+
+    /// Scalar kernels, used for the tails of the vector loops and as the portable fallback
+    template<class T>
+    std::size_t simd_find_scalar(const T* data, std::size_t n, T value)
+    {
+        for(std::size_t i = 0; i < n; ++i) {
+            if(data[i] == value)
+                return i;
+        }
+        return n;
+    }
+
+    template<class T>
+    std::size_t simd_count_scalar(const T* data, std::size_t n, T value)
+    {
+        std::size_t result = 0;
+        for(std::size_t i = 0; i < n; ++i)
+            result += (data[i] == value);
+        return result;
+    }
+
+    template<class T>
+    std::size_t simd_mismatch_scalar(const T* a, const T* b, std::size_t n)
+    {
+        for(std::size_t i = 0; i < n; ++i) {
+            if(!(a[i] == b[i]))
+                return i;
+        }
+        return n;
+    }
+
+    template<class T>
+    T simd_min_scalar(const T* data, std::size_t n, T result)
+    {
+        for(std::size_t i = 0; i < n; ++i) {
+            if(data[i] < result)
+                result = data[i];
+        }
+        return result;
+    }
+
+    template<class T>
+    T simd_max_scalar(const T* data, std::size_t n, T result)
+    {
+        for(std::size_t i = 0; i < n; ++i) {
+            if(result < data[i])
+                result = data[i];
+        }
+        return result;
+    }
+#ifdef NOE_STD_SIMD_X86
+    /// Lane comparison flavour of T
+    struct simd_float_tag {};
+    struct simd_double_tag {};
+
+    template<class T>
+    struct simd_kind
+    {
+        typedef std::integral_constant<std::size_t, sizeof(T)> type;
+    };
+
+    template<> struct simd_kind<float> { typedef simd_float_tag type; };
+    template<> struct simd_kind<double> { typedef simd_double_tag type; };
+
+    /// min / max flavour of an integral T, 64 bit integers have no AVX2 min / max
+    template<class T>
+    struct simd_minmax_kind
+    {
+        typedef std::integral_constant<int, std::is_integral<T>::value && sizeof(T) < 8 ? int(sizeof(T)) * (std::is_signed<T>::value ? -1 : 1) : 0> type;
+    };
+
+    inline unsigned simd_ctz(unsigned mask) { return static_cast<unsigned>(__builtin_ctz(mask)); }
+    inline unsigned simd_popcount(unsigned mask) { return static_cast<unsigned>(__builtin_popcount(mask)); }
+
+    // SSE2
+    inline __m128i simd_eq_sse2(__m128i a, __m128i b, std::integral_constant<std::size_t, 1>) { return _mm_cmpeq_epi8(a, b); }
+    inline __m128i simd_eq_sse2(__m128i a, __m128i b, std::integral_constant<std::size_t, 2>) { return _mm_cmpeq_epi16(a, b); }
+    inline __m128i simd_eq_sse2(__m128i a, __m128i b, std::integral_constant<std::size_t, 4>) { return _mm_cmpeq_epi32(a, b); }
+    inline __m128i simd_eq_sse2(__m128i a, __m128i b, std::integral_constant<std::size_t, 8>)
+    {
+        // no 64 bit compare before SSE4.1, both 32 bit halves have to match
+        __m128i eq = _mm_cmpeq_epi32(a, b);
+        return _mm_and_si128(eq, _mm_shuffle_epi32(eq, _MM_SHUFFLE(2, 3, 0, 1)));
+    }
+    inline __m128i simd_eq_sse2(__m128i a, __m128i b, simd_float_tag) { return _mm_castps_si128(_mm_cmpeq_ps(_mm_castsi128_ps(a), _mm_castsi128_ps(b))); }
+    inline __m128i simd_eq_sse2(__m128i a, __m128i b, simd_double_tag) { return _mm_castpd_si128(_mm_cmpeq_pd(_mm_castsi128_pd(a), _mm_castsi128_pd(b))); }
+
+    template<class T>
+    inline __m128i simd_splat_sse2(T value)
+    {
+        T lanes[sizeof(__m128i) / sizeof(T)];
+        for(std::size_t i = 0; i < sizeof(__m128i) / sizeof(T); ++i)
+            lanes[i] = value;
+        return _mm_loadu_si128(reinterpret_cast<const __m128i*>(lanes));
+    }
+
+    template<class T>
+    std::size_t simd_find_sse2(const T* data, std::size_t n, T value)
+    {
+        typedef typename simd_kind<T>::type kind;
+        const std::size_t lanes = sizeof(__m128i) / sizeof(T);
+        const __m128i needle = simd_splat_sse2(value);
+        std::size_t i = 0;
+        for(; i + lanes <= n; i += lanes) {
+            unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(simd_eq_sse2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i)), needle, kind())));
+            if(mask)
+                return i + simd_ctz(mask) / sizeof(T);
+        }
+        return i + simd_find_scalar(data + i, n - i, value);
+    }
+
+    template<class T>
+    std::size_t simd_count_sse2(const T* data, std::size_t n, T value)
+    {
+        typedef typename simd_kind<T>::type kind;
+        const std::size_t lanes = sizeof(__m128i) / sizeof(T);
+        const __m128i needle = simd_splat_sse2(value);
+        std::size_t bits = 0;
+        std::size_t i = 0;
+        for(; i + lanes <= n; i += lanes)
+            bits += simd_popcount(static_cast<unsigned>(_mm_movemask_epi8(simd_eq_sse2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i)), needle, kind()))));
+        return bits / sizeof(T) + simd_count_scalar(data + i, n - i, value);
+    }
+
+    template<class T>
+    std::size_t simd_mismatch_sse2(const T* a, const T* b, std::size_t n)
+    {
+        typedef typename simd_kind<T>::type kind;
+        const std::size_t lanes = sizeof(__m128i) / sizeof(T);
+        std::size_t i = 0;
+        for(; i + lanes <= n; i += lanes) {
+            __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+            __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+            unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(simd_eq_sse2(va, vb, kind()))) ^ 0xFFFFu;
+            if(mask)
+                return i + simd_ctz(mask) / sizeof(T);
+        }
+        return i + simd_mismatch_scalar(a + i, b + i, n - i);
+    }
+
+    // AVX2
+    __attribute__((target("avx2"))) inline __m256i simd_eq_avx2(__m256i a, __m256i b, std::integral_constant<std::size_t, 1>) { return _mm256_cmpeq_epi8(a, b); }
+    __attribute__((target("avx2"))) inline __m256i simd_eq_avx2(__m256i a, __m256i b, std::integral_constant<std::size_t, 2>) { return _mm256_cmpeq_epi16(a, b); }
+    __attribute__((target("avx2"))) inline __m256i simd_eq_avx2(__m256i a, __m256i b, std::integral_constant<std::size_t, 4>) { return _mm256_cmpeq_epi32(a, b); }
+    __attribute__((target("avx2"))) inline __m256i simd_eq_avx2(__m256i a, __m256i b, std::integral_constant<std::size_t, 8>) { return _mm256_cmpeq_epi64(a, b); }
+    __attribute__((target("avx2"))) inline __m256i simd_eq_avx2(__m256i a, __m256i b, simd_float_tag) { return _mm256_castps_si256(_mm256_cmp_ps(_mm256_castsi256_ps(a), _mm256_castsi256_ps(b), _CMP_EQ_OQ)); }
+    __attribute__((target("avx2"))) inline __m256i simd_eq_avx2(__m256i a, __m256i b, simd_double_tag) { return _mm256_castpd_si256(_mm256_cmp_pd(_mm256_castsi256_pd(a), _mm256_castsi256_pd(b), _CMP_EQ_OQ)); }
+
+    __attribute__((target("avx2"))) inline __m256i simd_min_avx2(__m256i a, __m256i b, std::integral_constant<int, -1>) { return _mm256_min_epi8(a, b); }
+    __attribute__((target("avx2"))) inline __m256i simd_min_avx2(__m256i a, __m256i b, std::integral_constant<int, 1>) { return _mm256_min_epu8(a, b); }
+    __attribute__((target("avx2"))) inline __m256i simd_min_avx2(__m256i a, __m256i b, std::integral_constant<int, -2>) { return _mm256_min_epi16(a, b); }
+    __attribute__((target("avx2"))) inline __m256i simd_min_avx2(__m256i a, __m256i b, std::integral_constant<int, 2>) { return _mm256_min_epu16(a, b); }
+    __attribute__((target("avx2"))) inline __m256i simd_min_avx2(__m256i a, __m256i b, std::integral_constant<int, -4>) { return _mm256_min_epi32(a, b); }
+    __attribute__((target("avx2"))) inline __m256i simd_min_avx2(__m256i a, __m256i b, std::integral_constant<int, 4>) { return _mm256_min_epu32(a, b); }
+    __attribute__((target("avx2"))) inline __m256i simd_max_avx2(__m256i a, __m256i b, std::integral_constant<int, -1>) { return _mm256_max_epi8(a, b); }
+    __attribute__((target("avx2"))) inline __m256i simd_max_avx2(__m256i a, __m256i b, std::integral_constant<int, 1>) { return _mm256_max_epu8(a, b); }
+    __attribute__((target("avx2"))) inline __m256i simd_max_avx2(__m256i a, __m256i b, std::integral_constant<int, -2>) { return _mm256_max_epi16(a, b); }
+    __attribute__((target("avx2"))) inline __m256i simd_max_avx2(__m256i a, __m256i b, std::integral_constant<int, 2>) { return _mm256_max_epu16(a, b); }
+    __attribute__((target("avx2"))) inline __m256i simd_max_avx2(__m256i a, __m256i b, std::integral_constant<int, -4>) { return _mm256_max_epi32(a, b); }
+    __attribute__((target("avx2"))) inline __m256i simd_max_avx2(__m256i a, __m256i b, std::integral_constant<int, 4>) { return _mm256_max_epu32(a, b); }
+
+    template<class T>
+    __attribute__((target("avx2"))) inline __m256i simd_splat_avx2(T value)
+    {
+        T lanes[sizeof(__m256i) / sizeof(T)];
+        for(std::size_t i = 0; i < sizeof(__m256i) / sizeof(T); ++i)
+            lanes[i] = value;
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lanes));
+    }
+
+    template<class T>
+    __attribute__((target("avx2"))) std::size_t simd_find_avx2(const T* data, std::size_t n, T value)
+    {
+        typedef typename simd_kind<T>::type kind;
+        const std::size_t lanes = sizeof(__m256i) / sizeof(T);
+        const __m256i needle = simd_splat_avx2(value);
+        std::size_t i = 0;
+        for(; i + lanes <= n; i += lanes) {
+            unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(simd_eq_avx2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i)), needle, kind())));
+            if(mask)
+                return i + simd_ctz(mask) / sizeof(T);
+        }
+        return i + simd_find_scalar(data + i, n - i, value);
+    }
+
+    template<class T>
+    __attribute__((target("avx2"))) std::size_t simd_count_avx2(const T* data, std::size_t n, T value)
+    {
+        typedef typename simd_kind<T>::type kind;
+        const std::size_t lanes = sizeof(__m256i) / sizeof(T);
+        const __m256i needle = simd_splat_avx2(value);
+        std::size_t bits = 0;
+        std::size_t i = 0;
+        for(; i + lanes <= n; i += lanes)
+            bits += simd_popcount(static_cast<unsigned>(_mm256_movemask_epi8(simd_eq_avx2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i)), needle, kind()))));
+        return bits / sizeof(T) + simd_count_scalar(data + i, n - i, value);
+    }
+
+    template<class T>
+    __attribute__((target("avx2"))) std::size_t simd_mismatch_avx2(const T* a, const T* b, std::size_t n)
+    {
+        typedef typename simd_kind<T>::type kind;
+        const std::size_t lanes = sizeof(__m256i) / sizeof(T);
+        std::size_t i = 0;
+        for(; i + lanes <= n; i += lanes) {
+            __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+            __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+            unsigned mask = ~static_cast<unsigned>(_mm256_movemask_epi8(simd_eq_avx2(va, vb, kind())));
+            if(mask)
+                return i + simd_ctz(mask) / sizeof(T);
+        }
+        return i + simd_mismatch_scalar(a + i, b + i, n - i);
+    }
+
+    template<class T, int Kind>
+    __attribute__((target("avx2"))) T simd_min_avx2(const T* data, std::size_t n, std::integral_constant<int, Kind> kind)
+    {
+        const std::size_t lanes = sizeof(__m256i) / sizeof(T);
+        if(n < lanes)
+            return simd_min_scalar(data + 1, n - 1, data[0]);
+
+        __m256i acc = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data));
+        std::size_t i = lanes;
+        for(; i + lanes <= n; i += lanes)
+            acc = simd_min_avx2(acc, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i)), kind);
+        T reduced[sizeof(__m256i) / sizeof(T)];
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(reduced), acc);
+        return simd_min_scalar(data + i, n - i, simd_min_scalar(reduced + 1, lanes - 1, reduced[0]));
+    }
+
+    template<class T>
+    inline T simd_min_avx2(const T* data, std::size_t n, std::integral_constant<int, 0>)
+    {
+        return simd_min_scalar(data + 1, n - 1, data[0]);
+    }
+
+    template<class T, int Kind>
+    __attribute__((target("avx2"))) T simd_max_avx2(const T* data, std::size_t n, std::integral_constant<int, Kind> kind)
+    {
+        const std::size_t lanes = sizeof(__m256i) / sizeof(T);
+        if(n < lanes)
+            return simd_max_scalar(data + 1, n - 1, data[0]);
+
+        __m256i acc = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data));
+        std::size_t i = lanes;
+        for(; i + lanes <= n; i += lanes)
+            acc = simd_max_avx2(acc, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i)), kind);
+        T reduced[sizeof(__m256i) / sizeof(T)];
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(reduced), acc);
+        return simd_max_scalar(data + i, n - i, simd_max_scalar(reduced + 1, lanes - 1, reduced[0]));
+    }
+
+    template<class T>
+    inline T simd_max_avx2(const T* data, std::size_t n, std::integral_constant<int, 0>)
+    {
+        return simd_max_scalar(data + 1, n - 1, data[0]);
+    }
+#endif // NOE_STD_SIMD_X86
+    template<class T>
+    std::size_t simd_mismatch(const T* a, const T* b, std::size_t n)
+    {
+#ifdef NOE_STD_SIMD_X86
+        switch(simd_current_isa()) {
+        case simd_isa_avx2: return simd_mismatch_avx2(a, b, n);
+        case simd_isa_sse2: return simd_mismatch_sse2(a, b, n);
+        default: break;
+        }
+#endif // NOE_STD_SIMD_X86
+        return simd_mismatch_scalar(a, b, n);
+    }
+}
+namespace simd
+{
+    template<class T>
+    bool equal(const T* a, const T* b, std::size_t n) noe_std_no_except
+    {
+        static_assert(is_vectorizable<T>::value, "noe_std::simd kernels need an arithmetic element type");
+        return detail::simd_mismatch(a, b, n) == n;
+    }
+
+    template<class T>
+    compare_result compare(const T* a, std::size_t a_size, const T* b, std::size_t b_size) noe_std_no_except
+    {
+        static_assert(is_vectorizable<T>::value, "noe_std::simd kernels need an arithmetic element type");
+        // skip to every element that is not equal, only those can decide the order
+        std::size_t n = a_size < b_size ? a_size : b_size;
+        bool unordered = false;
+        for(std::size_t i = detail::simd_mismatch(a, b, n); i < n; i += 1 + detail::simd_mismatch(a + i + 1, b + i + 1, n - i - 1)) {
+            if(a[i] < b[i])
+                return compare_less;
+            if(b[i] < a[i])
+                return compare_greater;
+            unordered = true;
+        }
+        if(a_size != b_size)
+            return a_size < b_size ? compare_less : compare_greater;
+        return unordered ? compare_unordered : compare_equal;
+    }
+
+    template<class T>
+    std::size_t find(const T* data, std::size_t n, T value) noe_std_no_except
+    {
+        static_assert(is_vectorizable<T>::value, "noe_std::simd kernels need an arithmetic element type");
+#ifdef NOE_STD_SIMD_X86
+        switch(detail::simd_current_isa()) {
+        case detail::simd_isa_avx2: return detail::simd_find_avx2(data, n, value);
+        case detail::simd_isa_sse2: return detail::simd_find_sse2(data, n, value);
+        default: break;
+        }
+#endif // NOE_STD_SIMD_X86
+        return detail::simd_find_scalar(data, n, value);
+    }
+
+    template<class T>
+    std::size_t count(const T* data, std::size_t n, T value) noe_std_no_except
+    {
+        static_assert(is_vectorizable<T>::value, "noe_std::simd kernels need an arithmetic element type");
+#ifdef NOE_STD_SIMD_X86
+        switch(detail::simd_current_isa()) {
+        case detail::simd_isa_avx2: return detail::simd_count_avx2(data, n, value);
+        case detail::simd_isa_sse2: return detail::simd_count_sse2(data, n, value);
+        default: break;
+        }
+#endif // NOE_STD_SIMD_X86
+        return detail::simd_count_scalar(data, n, value);
+    }
+
+    template<class T>
+    inline bool contains(const T* data, std::size_t n, T value) noe_std_no_except
+    {
+        return find(data, n, value) != n;
+    }
+
+    template<class T>
+    std::size_t min_element(const T* data, std::size_t n) noe_std_no_except
+    {
+        static_assert(is_vectorizable<T>::value, "noe_std::simd kernels need an arithmetic element type");
+        if(n == 0)
+            return 0;
+#ifdef NOE_STD_SIMD_X86
+        // integers: reduce to the minimum value, then locate its first occurrence,
+        // floats keep the scalar loop so NaN handling matches std::min_element
+        if(detail::simd_current_isa() == detail::simd_isa_avx2 && std::is_integral<T>::value)
+            return find(data, n, detail::simd_min_avx2(data, n, typename detail::simd_minmax_kind<T>::type()));
+#endif // NOE_STD_SIMD_X86
+        std::size_t result = 0;
+        for(std::size_t i = 1; i < n; ++i) {
+            if(data[i] < data[result])
+                result = i;
+        }
+        return result;
+    }
+
+    template<class T>
+    std::size_t max_element(const T* data, std::size_t n) noe_std_no_except
+    {
+        static_assert(is_vectorizable<T>::value, "noe_std::simd kernels need an arithmetic element type");
+        if(n == 0)
+            return 0;
+#ifdef NOE_STD_SIMD_X86
+        if(detail::simd_current_isa() == detail::simd_isa_avx2 && std::is_integral<T>::value)
+            return find(data, n, detail::simd_max_avx2(data, n, typename detail::simd_minmax_kind<T>::type()));
+#endif // NOE_STD_SIMD_X86
+        std::size_t result = 0;
+        for(std::size_t i = 1; i < n; ++i) {
+            if(data[result] < data[i])
+                result = i;
+        }
+        return result;
+    }
+}
+namespace detail
+{
+    /// Word operations for the bit kernels, each with a scalar, SSE2 and AVX2 form
+    struct simd_bit_and_op
+    {
+        static std::uint64_t apply(std::uint64_t a, std::uint64_t b) { return a & b; }
+#ifdef NOE_STD_SIMD_X86
+        static __m128i apply(__m128i a, __m128i b) { return _mm_and_si128(a, b); }
+        __attribute__((target("avx2"))) static __m256i apply(__m256i a, __m256i b) { return _mm256_and_si256(a, b); }
+#endif // NOE_STD_SIMD_X86
+    };
+
+    struct simd_bit_or_op
+    {
+        static std::uint64_t apply(std::uint64_t a, std::uint64_t b) { return a | b; }
+#ifdef NOE_STD_SIMD_X86
+        static __m128i apply(__m128i a, __m128i b) { return _mm_or_si128(a, b); }
+        __attribute__((target("avx2"))) static __m256i apply(__m256i a, __m256i b) { return _mm256_or_si256(a, b); }
+#endif // NOE_STD_SIMD_X86
+    };
+
+    struct simd_bit_xor_op
+    {
+        static std::uint64_t apply(std::uint64_t a, std::uint64_t b) { return a ^ b; }
+#ifdef NOE_STD_SIMD_X86
+        static __m128i apply(__m128i a, __m128i b) { return _mm_xor_si128(a, b); }
+        __attribute__((target("avx2"))) static __m256i apply(__m256i a, __m256i b) { return _mm256_xor_si256(a, b); }
+#endif // NOE_STD_SIMD_X86
+    };
+
+    struct simd_bit_andnot_op
+    {
+        static std::uint64_t apply(std::uint64_t a, std::uint64_t b) { return a & ~b; }
+#ifdef NOE_STD_SIMD_X86
+        // andnot intrinsics negate their first operand
+        static __m128i apply(__m128i a, __m128i b) { return _mm_andnot_si128(b, a); }
+        __attribute__((target("avx2"))) static __m256i apply(__m256i a, __m256i b) { return _mm256_andnot_si256(b, a); }
+#endif // NOE_STD_SIMD_X86
+    };
+
+    template<class OpT>
+    void simd_bit_op_scalar(std::uint64_t* dst, const std::uint64_t* src, std::size_t n)
+    {
+        for(std::size_t i = 0; i < n; ++i)
+            dst[i] = OpT::apply(dst[i], src[i]);
+    }
+
+    inline std::size_t simd_popcount_scalar(const std::uint64_t* words, std::size_t n)
+    {
+        std::size_t result = 0;
+        for(std::size_t i = 0; i < n; ++i) {
+            std::uint64_t w = words[i];
+            w = w - ((w >> 1) & 0x5555555555555555ull);
+            w = (w & 0x3333333333333333ull) + ((w >> 2) & 0x3333333333333333ull);
+            w = (w + (w >> 4)) & 0x0f0f0f0f0f0f0f0full;
+            result += static_cast<std::size_t>((w * 0x0101010101010101ull) >> 56);
+        }
+        return result;
+    }
+#ifdef NOE_STD_SIMD_X86
+    template<class OpT>
+    void simd_bit_op_sse2(std::uint64_t* dst, const std::uint64_t* src, std::size_t n)
+    {
+        std::size_t i = 0;
+        for(; i + 2 <= n; i += 2) {
+            __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+            __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), OpT::apply(a, b));
+        }
+        simd_bit_op_scalar<OpT>(dst + i, src + i, n - i);
+    }
+
+    template<class OpT>
+    __attribute__((target("avx2"))) void simd_bit_op_avx2(std::uint64_t* dst, const std::uint64_t* src, std::size_t n)
+    {
+        std::size_t i = 0;
+        for(; i + 4 <= n; i += 4) {
+            __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i));
+            __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), OpT::apply(a, b));
+        }
+        simd_bit_op_scalar<OpT>(dst + i, src + i, n - i);
+    }
+
+    /// Four independent accumulators so the popcnt latency overlaps
+    __attribute__((target("popcnt"))) inline std::size_t simd_popcount_popcnt(const std::uint64_t* words, std::size_t n)
+    {
+        std::uint64_t c0 = 0, c1 = 0, c2 = 0, c3 = 0;
+        std::size_t i = 0;
+        for(; i + 4 <= n; i += 4) {
+            c0 += static_cast<std::uint64_t>(__builtin_popcountll(words[i]));
+            c1 += static_cast<std::uint64_t>(__builtin_popcountll(words[i + 1]));
+            c2 += static_cast<std::uint64_t>(__builtin_popcountll(words[i + 2]));
+            c3 += static_cast<std::uint64_t>(__builtin_popcountll(words[i + 3]));
+        }
+        for(; i < n; ++i)
+            c0 += static_cast<std::uint64_t>(__builtin_popcountll(words[i]));
+        return static_cast<std::size_t>(c0 + c1 + c2 + c3);
+    }
+#endif // NOE_STD_SIMD_X86
+    inline std::uint64_t simd_extract_bits(const std::uint64_t* words, std::size_t bit, unsigned width) noe_std_no_except
+    {
+        std::size_t word = bit >> 6;
+        unsigned offset = static_cast<unsigned>(bit & 63);
+        std::uint64_t value = words[word] >> offset;
+        if(offset + width > 64)
+            value |= words[word + 1] << (64 - offset);
+        return width >= 64 ? value : value & ((std::uint64_t(1) << width) - 1);
+    }
+
+    inline void simd_unpack_bits_scalar(const std::uint64_t* words, std::size_t bit, unsigned width, std::size_t n, std::uint64_t* out)
+    {
+        for(std::size_t i = 0; i < n; ++i, bit += width)
+            out[i] = simd_extract_bits(words, bit, width);
+    }
+#ifdef NOE_STD_SIMD_X86
+    /// Four fields per step: each lane gathers the 8 bytes holding its field and shifts it down,
+    /// a field starts at most 7 bits into its first byte, so widths up to 57 fit in one load
+    __attribute__((target("avx2"))) inline void simd_unpack_bits_avx2(const std::uint64_t* words, std::size_t bit, unsigned width, std::size_t n, std::uint64_t* out)
+    {
+        const long long* bytes = reinterpret_cast<const long long*>(words);
+        const __m256i mask = _mm256_set1_epi64x(static_cast<long long>((std::uint64_t(1) << width) - 1));
+        const __m256i seven = _mm256_set1_epi64x(7);
+        const __m256i step = _mm256_set1_epi64x(static_cast<long long>(4 * width));
+        __m256i position = _mm256_add_epi64(_mm256_set1_epi64x(static_cast<long long>(bit)),
+                                            _mm256_set_epi64x(3 * width, 2 * width, width, 0));
+        std::size_t i = 0;
+        for(; i + 4 <= n; i += 4) {
+            __m256i value = _mm256_i64gather_epi64(bytes, _mm256_srli_epi64(position, 3), 1);
+            value = _mm256_and_si256(_mm256_srlv_epi64(value, _mm256_and_si256(position, seven)), mask);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), value);
+            position = _mm256_add_epi64(position, step);
+        }
+        simd_unpack_bits_scalar(words, bit + i * width, width, n - i, out + i);
+    }
+#endif // NOE_STD_SIMD_X86
+    template<class OpT>
+    void simd_bit_op(std::uint64_t* dst, const std::uint64_t* src, std::size_t n)
+    {
+#ifdef NOE_STD_SIMD_X86
+        switch(simd_current_isa()) {
+        case simd_isa_avx2: simd_bit_op_avx2<OpT>(dst, src, n); return;
+        case simd_isa_sse2: simd_bit_op_sse2<OpT>(dst, src, n); return;
+        default: break;
+        }
+#endif // NOE_STD_SIMD_X86
+        simd_bit_op_scalar<OpT>(dst, src, n);
+    }
+}
+namespace simd
+{
+    inline std::size_t popcount(const std::uint64_t* words, std::size_t n) noe_std_no_except
+    {
+#ifdef NOE_STD_SIMD_X86
+        if(detail::simd_has_popcnt())
+            return detail::simd_popcount_popcnt(words, n);
+#endif // NOE_STD_SIMD_X86
+        return detail::simd_popcount_scalar(words, n);
+    }
+
+    inline void bit_and(std::uint64_t* dst, const std::uint64_t* src, std::size_t n) noe_std_no_except
+    {
+        detail::simd_bit_op<detail::simd_bit_and_op>(dst, src, n);
+    }
+
+    inline void bit_or(std::uint64_t* dst, const std::uint64_t* src, std::size_t n) noe_std_no_except
+    {
+        detail::simd_bit_op<detail::simd_bit_or_op>(dst, src, n);
+    }
+
+    inline void bit_xor(std::uint64_t* dst, const std::uint64_t* src, std::size_t n) noe_std_no_except
+    {
+        detail::simd_bit_op<detail::simd_bit_xor_op>(dst, src, n);
+    }
+
+    inline void bit_andnot(std::uint64_t* dst, const std::uint64_t* src, std::size_t n) noe_std_no_except
+    {
+        detail::simd_bit_op<detail::simd_bit_andnot_op>(dst, src, n);
+    }
+
+    inline void unpack_bits(const std::uint64_t* words, std::size_t first_bit, unsigned width, std::size_t n, std::uint64_t* out) noe_std_no_except
+    {
+        if(width == 0) {
+            for(std::size_t i = 0; i < n; ++i)
+                out[i] = 0;
+            return;
+        }
+#ifdef NOE_STD_SIMD_X86
+        if(width <= 57 && detail::simd_current_isa() == detail::simd_isa_avx2) {
+            detail::simd_unpack_bits_avx2(words, first_bit, width, n, out);
+            return;
+        }
+#endif // NOE_STD_SIMD_X86
+        detail::simd_unpack_bits_scalar(words, first_bit, width, n, out);
+    }
+}
+namespace detail
+{
+    // arithmetic elements are compared with the noe_std::simd kernels, everything else element by element
+    template<class T>
+    inline bool contiguous_equal(const T* lhs, const T* rhs, std::size_t n, std::true_type)
+    {
+        return simd::equal(lhs, rhs, n);
+    }
+
+    template<class T>
+    bool contiguous_equal(const T* lhs, const T* rhs, std::size_t n, std::false_type)
+    {
+        for(std::size_t i = 0; i < n; ++i) {
+            if(lhs[i] != rhs[i])
+                return false;
+        }
+        return true;
+    }
+
+    template<class T>
+    inline bool contiguous_less(const T* lhs, std::size_t lhs_size, const T* rhs, std::size_t rhs_size, std::true_type)
+    {
+        return simd::compare(lhs, lhs_size, rhs, rhs_size) == simd::compare_less;
+    }
+
+    template<class T>
+    inline bool contiguous_less(const T* lhs, std::size_t lhs_size, const T* rhs, std::size_t rhs_size, std::false_type)
+    {
+        return std::lexicographical_compare(lhs, lhs + lhs_size, rhs, rhs + rhs_size);
+    }
+
+    template<class T>
+    inline bool contiguous_less_equal(const T* lhs, std::size_t lhs_size, const T* rhs, std::size_t rhs_size, std::true_type)
+    {
+        // single pass, compare_unordered (NaN) is neither less nor equal
+        simd::compare_result result = simd::compare(lhs, lhs_size, rhs, rhs_size);
+        return result == simd::compare_less || result == simd::compare_equal;
+    }
+
+    template<class T>
+    inline bool contiguous_less_equal(const T* lhs, std::size_t lhs_size, const T* rhs, std::size_t rhs_size, std::false_type)
+    {
+        return contiguous_less(lhs, lhs_size, rhs, rhs_size, std::false_type()) ||
+               (lhs_size == rhs_size && contiguous_equal(lhs, rhs, lhs_size, std::false_type()));
+    }
+}
+}
+
+#endif // GUARD_NOE_STD_simd_algorithm_H
@@ -0,0 +1,342 @@
+/**
+ * NoException Standard Library Container Implementation
+ * by Marvin Manese 2017
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+#ifndef GUARD_NOE_STD_small_vector_H
+#define GUARD_NOE_STD_small_vector_H
+
+#include <cstddef>
+#include <utility>
+#include "allocator.h"
+#include "macro.h"
+#include "vector.h"
+
+namespace noe_std
+{
+namespace detail
+{
+    /// Raw in-object buffer for the first N elements of a small_vector.
+    /// Kept as a base class so it outlives the elements destroyed by vector's storage.
+    template<class T, std::size_t N>
+    struct small_vector_storage
+    {
+        // user provided, so small_vector_storage() leaves the buffer uninitialized instead of zeroing it
+        small_vector_storage() {}
+
+        T* inline_data() { return reinterpret_cast<T*>(m_storage); }
+        const T* inline_data() const { return reinterpret_cast<const T*>(m_storage); }
+
+        alignas(T) unsigned char m_storage[sizeof(T) * N];
+    };
+
+    /// Allocator adaptor that never hands the inline buffer back to the wrapped allocator.
+    /// Every copy refers to the same inline buffer, so temporary storage created by vector
+    /// while growing still releases the right memory.
+    template<class AllocatorT>
+    struct small_vector_allocator : public AllocatorT
+    {
+        typedef typename AllocatorT::pointer    pointer;
+        typedef typename AllocatorT::size_type  size_type;
+
+        small_vector_allocator() : m_inline(0) {}
+        explicit small_vector_allocator(pointer inline_data, const AllocatorT& alloc = AllocatorT()) : AllocatorT(alloc), m_inline(inline_data) {}
+
+        void deallocate(pointer p, size_type n) noe_std_no_except
+        {
+            if(p != m_inline)
+                AllocatorT::deallocate(p, n);
+        }
+
+        // the extensions are only forwarded when AllocatorT has them, the inline buffer is never resized
+        template<class A = AllocatorT>
+        auto try_expand(pointer p, size_type old_n, size_type new_n) -> decltype(std::declval<A&>().try_expand(p, old_n, new_n))
+        {
+            return p != m_inline && A::try_expand(p, old_n, new_n);
+        }
+
+        template<class A = AllocatorT>
+        auto shrink_in_place(pointer p, size_type old_n, size_type new_n) -> decltype(std::declval<A&>().shrink_in_place(p, old_n, new_n))
+        {
+            return p != m_inline && A::shrink_in_place(p, old_n, new_n);
+        }
+
+        template<class A = AllocatorT>
+        auto reallocate(pointer p, size_type old_n, size_type new_n) -> decltype(std::declval<A&>().reallocate(p, old_n, new_n))
+        {
+            return p != m_inline ? A::reallocate(p, old_n, new_n) : pointer(0);
+        }
+
+        pointer m_inline;
+    };
+}
+    /// vector that keeps its first N elements inside the object and only
+    /// spills to the allocator once it grows beyond that
+    template<class T,
+             std::size_t N,
+             class AllocatorT = allocator<T>>
+    class small_vector : private detail::small_vector_storage<T, N>,
+                         private vector<T, detail::small_vector_allocator<AllocatorT>>
+    {
+        static_assert(N > 0, "small_vector needs at least one inline element");
+
+        typedef detail::small_vector_storage<T, N>                          storage_t;
+        typedef vector<T, detail::small_vector_allocator<AllocatorT>>       base_t;
+        typedef typename base_t::impl_t                                     impl_t;
+        typedef typename base_t::trivially_relocatable_t                    trivially_relocatable_t;
+
+    public:
+        typedef AllocatorT                          allocator_type;
+        typedef typename base_t::value_type         value_type;
+        typedef typename base_t::size_type          size_type;
+        typedef typename base_t::difference_type    difference_type;
+        typedef typename base_t::reference          reference;
+        typedef typename base_t::const_reference    const_reference;
+        typedef typename base_t::pointer            pointer;
+        typedef typename base_t::const_pointer      const_pointer;
+        typedef typename base_t::iterator           iterator;
+        typedef typename base_t::const_iterator     const_iterator;
+
+        enum : size_type { inline_capacity = N };
+
+        explicit small_vector(const allocator_type& alloc = allocator_type());
+        small_vector(const small_vector& rhs);
+        small_vector& operator=(const small_vector& rhs);
+#if __cplusplus >= 201103L
+        small_vector(small_vector&& rhs);
+        small_vector& operator=(small_vector&& rhs);
+#endif // __cplusplus >= 201103L
+        template<class InputIt,
+                 class = typename std::enable_if<!std::is_integral<InputIt>::value>::type>
+        small_vector(InputIt first, InputIt last, const allocator_type& alloc = allocator_type());
+        explicit small_vector(size_type count, const T& t = T(), const allocator_type& alloc = allocator_type());
+
+        using base_t::operator[];
+        using base_t::front;
+        using base_t::back;
+        using base_t::data;
+
+        using base_t::begin;
+        using base_t::cbegin;
+        using base_t::end;
+        using base_t::cend;
+
+        using base_t::empty;
+        using base_t::size;
+        using base_t::max_size;
+        using base_t::reserve;
+        using base_t::capacity;
+        void shrink_to_fit();
+        bool is_inline() const noe_std_no_except { return this->m_member.m_data == storage_t::inline_data(); }
+
+        using base_t::clear;
+        using base_t::insert;
+#if __cplusplus >= 201103L
+        using base_t::emplace;
+#endif // __cplusplus >= 201103L
+        using base_t::append;
+        using base_t::erase;
+        using base_t::push_back;
+#if __cplusplus >= 201103L
+        using base_t::emplace_back;
+#endif // __cplusplus >= 201103L
+        using base_t::pop_back;
+        using base_t::resize;
+        using base_t::resize_default_init;
+        using base_t::append_uninitialized;
+        using base_t::commit;
+        void swap(small_vector& other);
+
+    private:
+        template<class U, std::size_t M, class AllocatorU, class Pred> friend typename small_vector<U, M, AllocatorU>::size_type erase_if(small_vector<U, M, AllocatorU>& v, Pred pred);
+
+        void reset_to_inline() noe_std_no_except;
+        void release_heap() noe_std_no_except;
+        void take(small_vector& rhs);
+    };
+
+    template<class T, std::size_t N, class AllocatorT>
+    small_vector<T, N, AllocatorT>::small_vector(const allocator_type& alloc)
+    {
+        this->allocator() = detail::small_vector_allocator<AllocatorT>(storage_t::inline_data(), alloc);
+        reset_to_inline();
+    }
+
+    template<class T, std::size_t N, class AllocatorT>
+    small_vector<T, N, AllocatorT>::small_vector(const small_vector& rhs) :
+        storage_t(), base_t()
+    {
+        this->allocator() = detail::small_vector_allocator<AllocatorT>(storage_t::inline_data(), rhs.allocator());
+        reset_to_inline();
+        append(rhs.m_member.m_data, rhs.m_member.m_data + rhs.m_member.m_size);
+    }
+
+    template<class T, std::size_t N, class AllocatorT>
+    small_vector<T, N, AllocatorT>& small_vector<T, N, AllocatorT>::operator=(const small_vector& rhs)
+    {
+        if(this != &rhs) {
+            clear();
+            append(rhs.m_member.m_data, rhs.m_member.m_data + rhs.m_member.m_size); // reuses the current buffer when it is large enough
+        }
+        return *this;
+    }
+#if __cplusplus >= 201103L
+    template<class T, std::size_t N, class AllocatorT>
+    small_vector<T, N, AllocatorT>::small_vector(small_vector&& rhs)
+    {
+        this->allocator() = detail::small_vector_allocator<AllocatorT>(storage_t::inline_data(), rhs.allocator());
+        reset_to_inline();
+        take(rhs);
+    }
+
+    template<class T, std::size_t N, class AllocatorT>
+    small_vector<T, N, AllocatorT>& small_vector<T, N, AllocatorT>::operator=(small_vector&& rhs)
+    {
+        if(this != &rhs) {
+            clear();
+            take(rhs);
+        }
+        return *this;
+    }
+#endif // __cplusplus >= 201103L
+    template<class T, std::size_t N, class AllocatorT>
+    template<class InputIt, class>
+    small_vector<T, N, AllocatorT>::small_vector(InputIt first, InputIt last, const allocator_type& alloc)
+    {
+        this->allocator() = detail::small_vector_allocator<AllocatorT>(storage_t::inline_data(), alloc);
+        reset_to_inline();
+        append(first, last);
+    }
+
+    template<class T, std::size_t N, class AllocatorT>
+    small_vector<T, N, AllocatorT>::small_vector(size_type count, const T& t, const allocator_type& alloc)
+    {
+        this->allocator() = detail::small_vector_allocator<AllocatorT>(storage_t::inline_data(), alloc);
+        reset_to_inline();
+        insert(end(), count, t);
+    }
+
+    template<class T, std::size_t N, class AllocatorT>
+    void small_vector<T, N, AllocatorT>::shrink_to_fit()
+    {
+        if(is_inline())
+            return;
+
+        size_type size = this->m_member.m_size;
+        if(size > N) {
+            base_t::shrink_to_fit(); // stays on the heap
+            return;
+        }
+
+        // move back into the inline buffer
+        impl_t tmp(this->allocator());
+        tmp.m_data = storage_t::inline_data();
+        tmp.m_capacity = N;
+        pointer data = this->m_member.m_data;
+        this->relocate_range(data, data + size, tmp.m_data, trivially_relocatable_t());
+        tmp.m_size = size;
+        if(trivially_relocatable_t::value)
+            this->m_member.m_size = 0; // objects now live in the inline buffer
+        tmp.swap(this->m_member); // tmp now owns the heap buffer and releases it
+    }
+
+    template<class T, std::size_t N, class AllocatorT>
+    void small_vector<T, N, AllocatorT>::swap(small_vector& other)
+    {
+        if(!is_inline() && !other.is_inline()) {
+            this->m_member.swap(other.m_member); // both on the heap, only exchange the buffers
+            return;
+        }
+        small_vector tmp(std::move(other));
+        other = std::move(*this);
+        *this = std::move(tmp);
+    }
+
+    template<class T, std::size_t N, class AllocatorT>
+    inline void small_vector<T, N, AllocatorT>::reset_to_inline() noe_std_no_except
+    {
+        this->m_member.m_data = storage_t::inline_data();
+        this->m_member.m_capacity = N;
+        this->m_member.m_size = 0;
+    }
+
+    template<class T, std::size_t N, class AllocatorT>
+    void small_vector<T, N, AllocatorT>::release_heap() noe_std_no_except
+    {
+        // expects all elements to be destroyed already
+        if(!is_inline()) {
+            this->allocator().deallocate(this->m_member.m_data, this->m_member.m_capacity);
+            reset_to_inline();
+        }
+    }
+
+    template<class T, std::size_t N, class AllocatorT>
+    void small_vector<T, N, AllocatorT>::take(small_vector& rhs)
+    {
+        // expects this to be empty
+        if(!rhs.is_inline()) {
+            release_heap();
+            this->m_member.m_data = rhs.m_member.m_data;
+            this->m_member.m_capacity = rhs.m_member.m_capacity;
+            this->m_member.m_size = rhs.m_member.m_size;
+            rhs.reset_to_inline(); // transfer ownership
+            return;
+        }
+
+        // rhs elements live inside rhs, our buffer always holds at least N elements
+        size_type size = rhs.m_member.m_size;
+        pointer data = rhs.m_member.m_data;
+        this->relocate_range(data, data + size, this->m_member.m_data, trivially_relocatable_t());
+        this->m_member.m_size = size;
+        if(trivially_relocatable_t::value)
+            rhs.m_member.m_size = 0;
+        else
+            rhs.clear();
+    }
+
+    template<class T, std::size_t N, class AllocatorT, class Pred>
+    inline typename small_vector<T, N, AllocatorT>::size_type erase_if(small_vector<T, N, AllocatorT>& v, Pred pred)
+    {
+        return erase_if(static_cast<typename small_vector<T, N, AllocatorT>::base_t&>(v), pred);
+    }
+
+    template<class T, std::size_t N, class AllocatorT>
+    bool operator==(const small_vector<T, N, AllocatorT>& lhs, const small_vector<T, N, AllocatorT>& rhs)
+    {
+        return lhs.size() == rhs.size() &&
+               detail::contiguous_equal(lhs.data(), rhs.data(), lhs.size(), std::integral_constant<bool, simd::is_vectorizable<T>::value>());
+    }
+
+    template<class T, std::size_t N, class AllocatorT>
+    inline bool operator!=(const small_vector<T, N, AllocatorT>& lhs, const small_vector<T, N, AllocatorT>& rhs)
+    {
+        return !(lhs == rhs);
+    }
+}
+namespace std
+{
+    template<class T, std::size_t N, class AllocatorT>
+    inline void swap(noe_std::small_vector<T, N, AllocatorT>& v1, noe_std::small_vector<T, N, AllocatorT>& v2)
+    {
+        v1.swap(v2);
+    }
+}
+
+#endif // GUARD_NOE_STD_small_vector_H
@@ -0,0 +1,540 @@
+/**
+ * NoException Standard Library Container Implementation
+ * by Marvin Manese 2017
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+#ifndef GUARD_NOE_STD_soa_vector_H
+#define GUARD_NOE_STD_soa_vector_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include "allocator.h"
+#include "growth_policy.h"
+#include "macro.h"
+#include "type_traits.h"
+
+namespace noe_std
+{
+namespace detail
+{
+    template<std::size_t... Is> struct soa_indices {};
+    template<std::size_t N, std::size_t... Is> struct make_soa_indices : make_soa_indices<N - 1, N - 1, Is...> {};
+    template<std::size_t... Is> struct make_soa_indices<0, Is...> { typedef soa_indices<Is...> type; };
+
+    // evaluates a pack expansion in order, used to run a statement for every column
+    inline void soa_expand(std::initializer_list<int>) {}
+
+    template<class... Ts> struct soa_row_bytes;
+    template<> struct soa_row_bytes<> { enum : std::size_t { value = 0 }; };
+    template<class T, class... Ts> struct soa_row_bytes<T, Ts...> { enum : std::size_t { value = sizeof(T) + soa_row_bytes<Ts...>::value }; };
+
+    template<class... Ts, std::size_t... Is>
+    std::tuple<Ts*...> soa_column_pointers(unsigned char* block, const std::size_t* offsets, soa_indices<Is...>)
+    {
+        return std::tuple<Ts*...>(reinterpret_cast<Ts*>(block + offsets[Is])...);
+    }
+
+    /// Random access iterator over the rows of a soa_vector, dereferencing yields a tuple of references
+    template<class VectorT, class Reference>
+    class soa_iterator
+    {
+    public:
+        typedef std::random_access_iterator_tag         iterator_category;
+        typedef typename VectorT::value_type            value_type;
+        typedef std::ptrdiff_t                          difference_type;
+        typedef Reference                               reference;
+        typedef void                                    pointer;
+
+        soa_iterator() : m_vector(0), m_index(0) {}
+        soa_iterator(VectorT* v, std::size_t index) : m_vector(v), m_index(index) {}
+        // iterator to const_iterator
+        template<class V, class R>
+        soa_iterator(const soa_iterator<V, R>& rhs) : m_vector(rhs.m_vector), m_index(rhs.m_index) {}
+
+        reference operator*() const { return (*m_vector)[m_index]; }
+        reference operator[](difference_type n) const { return (*m_vector)[m_index + n]; }
+        std::size_t index() const { return m_index; }
+
+        soa_iterator& operator++() { ++m_index; return *this; }
+        soa_iterator operator++(int) { soa_iterator it(*this); ++m_index; return it; }
+        soa_iterator& operator--() { --m_index; return *this; }
+        soa_iterator operator--(int) { soa_iterator it(*this); --m_index; return it; }
+        soa_iterator& operator+=(difference_type n) { m_index += n; return *this; }
+        soa_iterator& operator-=(difference_type n) { m_index -= n; return *this; }
+        soa_iterator operator+(difference_type n) const { return soa_iterator(m_vector, m_index + n); }
+        soa_iterator operator-(difference_type n) const { return soa_iterator(m_vector, m_index - n); }
+        friend soa_iterator operator+(difference_type n, const soa_iterator& it) { return it + n; }
+        difference_type operator-(const soa_iterator& rhs) const { return difference_type(m_index) - difference_type(rhs.m_index); }
+
+        bool operator==(const soa_iterator& rhs) const { return m_index == rhs.m_index; }
+        bool operator!=(const soa_iterator& rhs) const { return m_index != rhs.m_index; }
+        bool operator<(const soa_iterator& rhs) const { return m_index < rhs.m_index; }
+        bool operator<=(const soa_iterator& rhs) const { return m_index <= rhs.m_index; }
+        bool operator>(const soa_iterator& rhs) const { return m_index > rhs.m_index; }
+        bool operator>=(const soa_iterator& rhs) const { return m_index >= rhs.m_index; }
+
+    private:
+        template<class V, class R> friend class soa_iterator;
+
+        VectorT*    m_vector;
+        std::size_t m_index;
+    };
+}
+    /// Contiguous view of one soa_vector column, valid until the vector reallocates
+    template<class T>
+    class soa_span
+    {
+    public:
+        typedef T               value_type;
+        typedef std::size_t     size_type;
+        typedef T*              pointer;
+        typedef T&              reference;
+        typedef T*              iterator;
+
+        soa_span() noe_std_no_except : m_data(0), m_size(0) {}
+        soa_span(pointer data, size_type size) noe_std_no_except : m_data(data), m_size(size) {}
+
+        pointer data() const noe_std_no_except { return m_data; }
+        size_type size() const noe_std_no_except { return m_size; }
+        bool empty() const noe_std_no_except { return (m_size == 0); }
+        iterator begin() const noe_std_no_except { return m_data; }
+        iterator end() const noe_std_no_except { return m_data + m_size; }
+        reference operator[](size_type n) const { return m_data[n]; }
+
+    private:
+        pointer     m_data;
+        size_type   m_size;
+    };
+
+    /// Structure of arrays: one contiguous column per field, all sharing one size, one capacity
+    /// and one allocation, so a pass over a single field only pulls that field through the cache.
+    /// Columns start on cache line boundaries, column<I>() / span<I>() hand them to SIMD loops,
+    /// operator[] and the iterators give rows as tuples of references for row oriented code.
+    /// Like vector, insertions return false and leave the container untouched if allocation fails.
+    /// GrowthPolicyT sizes the shared block as it does for vector (see growth_policy.h), with the
+    /// bytes of one row as the value size; soa_vector<Ts...> uses double_growth_policy.
+    template<class GrowthPolicyT, class... Ts>
+    class basic_soa_vector
+    {
+        static_assert(sizeof...(Ts) > 0, "soa_vector needs at least one column");
+
+        typedef typename detail::make_soa_indices<sizeof...(Ts)>::type  indices_t;
+        typedef aligned_allocator<unsigned char, cache_line_size>       block_allocator_t;
+        enum : std::size_t { column_count = sizeof...(Ts) };
+
+    public:
+        typedef std::tuple<Ts...>           value_type;
+        typedef std::tuple<Ts&...>          reference;
+        typedef std::tuple<const Ts&...>    const_reference;
+        typedef std::size_t                 size_type;
+        typedef std::ptrdiff_t              difference_type;
+        typedef detail::soa_iterator<basic_soa_vector, reference>               iterator;
+        typedef detail::soa_iterator<const basic_soa_vector, const_reference>   const_iterator;
+
+        template<std::size_t I>
+        struct column_type
+        {
+            typedef typename std::tuple_element<I, value_type>::type type;
+        };
+
+        basic_soa_vector() noe_std_no_except : m_columns(), m_size(0), m_capacity(0), m_block(0), m_block_bytes(0) {}
+        basic_soa_vector(const basic_soa_vector& rhs);
+        basic_soa_vector(basic_soa_vector&& rhs) noe_std_no_except;
+        basic_soa_vector& operator=(const basic_soa_vector& rhs);
+        basic_soa_vector& operator=(basic_soa_vector&& rhs) noe_std_no_except;
+        ~basic_soa_vector();
+
+        reference operator[](size_type n) { return row(n, indices_t()); }
+        const_reference operator[](size_type n) const { return row(n, indices_t()); }
+        reference front() { return (*this)[0]; }
+        const_reference front() const { return (*this)[0]; }
+        reference back() { return (*this)[m_size - 1]; }
+        const_reference back() const { return (*this)[m_size - 1]; }
+
+        template<std::size_t I> typename column_type<I>::type* column() noe_std_no_except { return std::get<I>(m_columns); }
+        template<std::size_t I> const typename column_type<I>::type* column() const noe_std_no_except { return std::get<I>(m_columns); }
+        template<std::size_t I> soa_span<typename column_type<I>::type> span() noe_std_no_except { return soa_span<typename column_type<I>::type>(column<I>(), m_size); }
+        template<std::size_t I> soa_span<const typename column_type<I>::type> span() const noe_std_no_except { return soa_span<const typename column_type<I>::type>(column<I>(), m_size); }
+
+        iterator begin() { return iterator(this, 0); }
+        const_iterator begin() const { return const_iterator(this, 0); }
+        const_iterator cbegin() const { return const_iterator(this, 0); }
+        iterator end() { return iterator(this, m_size); }
+        const_iterator end() const { return const_iterator(this, m_size); }
+        const_iterator cend() const { return const_iterator(this, m_size); }
+
+        bool empty() const noe_std_no_except { return (m_size == 0); }
+        size_type size() const noe_std_no_except { return m_size; }
+        size_type max_size() const noe_std_no_except;
+        size_type capacity() const noe_std_no_except { return m_capacity; }
+        bool reserve(size_type n);
+        bool shrink_to_fit();
+
+        void clear();
+        bool push_back(const value_type& row);
+        bool push_back(value_type&& row);
+        // one argument per column
+        template<class... Args> bool emplace_back(Args&&... args);
+        void pop_back();
+        void erase(iterator it);
+        bool resize(size_type n);
+        void swap(basic_soa_vector& other) noe_std_no_except;
+
+    private:
+        template<std::size_t... Is> reference row(size_type n, detail::soa_indices<Is...>) { return reference(std::get<Is>(m_columns)[n]...); }
+        template<std::size_t... Is> const_reference row(size_type n, detail::soa_indices<Is...>) const { return const_reference(std::get<Is>(m_columns)[n]...); }
+
+        static bool layout(size_type capacity, std::size_t (&offsets)[column_count], std::size_t& bytes);
+        bool check_capacity(size_type required);
+        bool grow(size_type new_capacity);
+        template<std::size_t... Is> void relocate_columns(std::tuple<Ts*...>& to, detail::soa_indices<Is...>);
+        template<class T> static void relocate(T* from, T* to, size_type n, std::true_type);
+        template<class T> static void relocate(T* from, T* to, size_type n, std::false_type);
+        template<std::size_t... Is, class... Args> void construct_row(size_type n, detail::soa_indices<Is...>, Args&&... args);
+        template<std::size_t... Is> void copy_row(size_type n, const value_type& row, detail::soa_indices<Is...>);
+        template<std::size_t... Is> void move_row(size_type n, value_type& row, detail::soa_indices<Is...>);
+        template<std::size_t... Is> void default_init_rows(size_type first, size_type last, detail::soa_indices<Is...>);
+        template<std::size_t... Is> void destroy_rows(size_type first, size_type last, detail::soa_indices<Is...>);
+        template<std::size_t... Is> void shift_down(size_type index, detail::soa_indices<Is...>);
+        template<class T> static void destroy(T*, T*, std::true_type) {}
+        template<class T> static void destroy(T* first, T* last, std::false_type);
+        void release();
+
+        std::tuple<Ts*...>  m_columns;
+        size_type           m_size;
+        size_type           m_capacity;
+        unsigned char*      m_block;
+        std::size_t         m_block_bytes;
+    };
+
+    /// basic_soa_vector with the default growth policy
+    template<class... Ts>
+    using soa_vector = basic_soa_vector<double_growth_policy, Ts...>;
+
+    template<class GrowthPolicyT, class... Ts>
+    basic_soa_vector<GrowthPolicyT, Ts...>::basic_soa_vector(const basic_soa_vector& rhs)
+        : m_columns(), m_size(0), m_capacity(0), m_block(0), m_block_bytes(0)
+    {
+        if(!rhs.m_size || !grow(rhs.m_size))
+            return;
+        for(; m_size < rhs.m_size; ++m_size)
+            copy_row(m_size, rhs[m_size], indices_t());
+    }
+
+    template<class GrowthPolicyT, class... Ts>
+    basic_soa_vector<GrowthPolicyT, Ts...>::basic_soa_vector(basic_soa_vector&& rhs) noe_std_no_except
+        : m_columns(rhs.m_columns), m_size(rhs.m_size), m_capacity(rhs.m_capacity), m_block(rhs.m_block), m_block_bytes(rhs.m_block_bytes)
+    {
+        rhs.m_columns = std::tuple<Ts*...>();
+        rhs.m_size = 0;
+        rhs.m_capacity = 0;
+        rhs.m_block = 0;
+        rhs.m_block_bytes = 0;
+    }
+
+    template<class GrowthPolicyT, class... Ts>
+    basic_soa_vector<GrowthPolicyT, Ts...>& basic_soa_vector<GrowthPolicyT, Ts...>::operator=(const basic_soa_vector& rhs)
+    {
+        if(this != &rhs) {
+            basic_soa_vector copy(rhs);
+            swap(copy);
+        }
+        return *this;
+    }
+
+    template<class GrowthPolicyT, class... Ts>
+    basic_soa_vector<GrowthPolicyT, Ts...>& basic_soa_vector<GrowthPolicyT, Ts...>::operator=(basic_soa_vector&& rhs) noe_std_no_except
+    {
+        if(this != &rhs) {
+            release();
+            swap(rhs);
+        }
+        return *this;
+    }
+
+    template<class GrowthPolicyT, class... Ts>
+    basic_soa_vector<GrowthPolicyT, Ts...>::~basic_soa_vector()
+    {
+        release();
+    }
+
+    template<class GrowthPolicyT, class... Ts>
+    typename basic_soa_vector<GrowthPolicyT, Ts...>::size_type basic_soa_vector<GrowthPolicyT, Ts...>::max_size() const noe_std_no_except
+    {
+        // every column may need up to a cache line of padding
+        const std::size_t row_bytes = detail::soa_row_bytes<Ts...>::value;
+        return (block_allocator_t().max_size() - column_count * cache_line_size) / row_bytes;
+    }
+
+    template<class GrowthPolicyT, class... Ts>
+    bool basic_soa_vector<GrowthPolicyT, Ts...>::reserve(size_type n)
+    {
+        if(n <= m_capacity)
+            return true;
+        return grow(std::max(n, GrowthPolicyT::fit(n, detail::soa_row_bytes<Ts...>::value)));
+    }
+
+    template<class GrowthPolicyT, class... Ts>
+    bool basic_soa_vector<GrowthPolicyT, Ts...>::shrink_to_fit()
+    {
+        if(m_size == m_capacity)
+            return true;
+        if(!m_size) {
+            release();
+            return true;
+        }
+        return grow(m_size);
+    }
+
+    template<class GrowthPolicyT, class... Ts>
+    void basic_soa_vector<GrowthPolicyT, Ts...>::clear()
+    {
+        destroy_rows(0, m_size, indices_t());
+        m_size = 0;
+    }
+
+    template<class GrowthPolicyT, class... Ts>
+    bool basic_soa_vector<GrowthPolicyT, Ts...>::push_back(const value_type& row)
+    {
+        if(!check_capacity(m_size + 1))
+            return false;
+        copy_row(m_size, row, indices_t());
+        ++m_size;
+        return true;
+    }
+
+    template<class GrowthPolicyT, class... Ts>
+    bool basic_soa_vector<GrowthPolicyT, Ts...>::push_back(value_type&& row)
+    {
+        if(!check_capacity(m_size + 1))
+            return false;
+        move_row(m_size, row, indices_t());
+        ++m_size;
+        return true;
+    }
+
+    template<class GrowthPolicyT, class... Ts>
+    template<class... Args>
+    bool basic_soa_vector<GrowthPolicyT, Ts...>::emplace_back(Args&&... args)
+    {
+        static_assert(sizeof...(Args) == sizeof...(Ts), "soa_vector::emplace_back takes one argument per column");
+        if(!check_capacity(m_size + 1))
+            return false;
+        construct_row(m_size, indices_t(), std::forward<Args>(args)...);
+        ++m_size;
+        return true;
+    }
+
+    template<class GrowthPolicyT, class... Ts>
+    void basic_soa_vector<GrowthPolicyT, Ts...>::pop_back()
+    {
+        destroy_rows(m_size - 1, m_size, indices_t());
+        --m_size;
+    }
+
+    template<class GrowthPolicyT, class... Ts>
+    void basic_soa_vector<GrowthPolicyT, Ts...>::erase(iterator it)
+    {
+        shift_down(it.index(), indices_t());
+        pop_back();
+    }
+
+    template<class GrowthPolicyT, class... Ts>
+    bool basic_soa_vector<GrowthPolicyT, Ts...>::resize(size_type n)
+    {
+        if(n > m_size) {
+            if(!check_capacity(n))
+                return false;
+            default_init_rows(m_size, n, indices_t());
+        }
+        else {
+            destroy_rows(n, m_size, indices_t());
+        }
+        m_size = n;
+        return true;
+    }
+
+    template<class GrowthPolicyT, class... Ts>
+    void basic_soa_vector<GrowthPolicyT, Ts...>::swap(basic_soa_vector& other) noe_std_no_except
+    {
+        std::swap(m_columns, other.m_columns);
+        std::swap(m_size, other.m_size);
+        std::swap(m_capacity, other.m_capacity);
+        std::swap(m_block, other.m_block);
+        std::swap(m_block_bytes, other.m_block_bytes);
+    }
+
+    template<class GrowthPolicyT, class... Ts>
+    bool basic_soa_vector<GrowthPolicyT, Ts...>::layout(size_type capacity, std::size_t (&offsets)[column_count], std::size_t& bytes)
+    {
+        const std::size_t sizes[] = { sizeof(Ts)... };
+        const std::size_t alignments[] = { (alignof(Ts) > cache_line_size ? alignof(Ts) : std::size_t(cache_line_size))... };
+        const std::size_t limit = std::numeric_limits<std::size_t>::max();
+        bytes = 0;
+        for(std::size_t i = 0; i < column_count; ++i) {
+            if(bytes > limit - alignments[i] || capacity > (limit - alignments[i] - bytes) / sizes[i])
+                return false;
+            offsets[i] = (bytes + alignments[i] - 1) & ~(alignments[i] - 1);
+            bytes = offsets[i] + capacity * sizes[i];
+        }
+        return true;
+    }
+
+    template<class GrowthPolicyT, class... Ts>
+    bool basic_soa_vector<GrowthPolicyT, Ts...>::check_capacity(size_type required)
+    {
+        if(required <= m_capacity)
+            return true;
+        if(required > max_size())
+            return false;
+        return grow(std::max(required, std::min(GrowthPolicyT::grow(m_capacity, required, detail::soa_row_bytes<Ts...>::value), max_size())));
+    }
+
+    template<class GrowthPolicyT, class... Ts>
+    bool basic_soa_vector<GrowthPolicyT, Ts...>::grow(size_type new_capacity)
+    {
+        // one block for every column, each column is relocated once
+        std::size_t offsets[column_count];
+        std::size_t bytes;
+        if(!layout(new_capacity, offsets, bytes))
+            return false;
+        unsigned char* block = block_allocator_t().allocate(bytes);
+        if(!block)
+            return false;
+
+        std::tuple<Ts*...> columns = detail::soa_column_pointers<Ts...>(block, offsets, indices_t());
+        relocate_columns(columns, indices_t());
+        if(m_block)
+            block_allocator_t().deallocate(m_block, m_block_bytes);
+        m_columns = columns;
+        m_capacity = new_capacity;
+        m_block = block;
+        m_block_bytes = bytes;
+        return true;
+    }
+
+    template<class GrowthPolicyT, class... Ts>
+    template<std::size_t... Is>
+    void basic_soa_vector<GrowthPolicyT, Ts...>::relocate_columns(std::tuple<Ts*...>& to, detail::soa_indices<Is...>)
+    {
+        detail::soa_expand({ (relocate(std::get<Is>(m_columns), std::get<Is>(to), m_size,
+                                       std::integral_constant<bool, is_trivially_relocatable<typename column_type<Is>::type>::value>()), 0)... });
+    }
+
+    template<class GrowthPolicyT, class... Ts>
+    template<class T>
+    void basic_soa_vector<GrowthPolicyT, Ts...>::relocate(T* from, T* to, size_type n, std::true_type)
+    {
+        if(n)
+            std::memcpy(static_cast<void*>(to), static_cast<const void*>(from), n * sizeof(T));
+    }
+
+    template<class GrowthPolicyT, class... Ts>
+    template<class T>
+    void basic_soa_vector<GrowthPolicyT, Ts...>::relocate(T* from, T* to, size_type n, std::false_type)
+    {
+        for(size_type i = 0; i < n; ++i) {
+            ::new(static_cast<void*>(to + i)) T(std::move_if_noexcept(from[i]));
+            from[i].~T();
+        }
+    }
+
+    template<class GrowthPolicyT, class... Ts>
+    template<std::size_t... Is, class... Args>
+    void basic_soa_vector<GrowthPolicyT, Ts...>::construct_row(size_type n, detail::soa_indices<Is...>, Args&&... args)
+    {
+        detail::soa_expand({ (::new(static_cast<void*>(std::get<Is>(m_columns) + n)) typename column_type<Is>::type(std::forward<Args>(args)), 0)... });
+    }
+
+    template<class GrowthPolicyT, class... Ts>
+    template<std::size_t... Is>
+    void basic_soa_vector<GrowthPolicyT, Ts...>::copy_row(size_type n, const value_type& row, detail::soa_indices<Is...>)
+    {
+        detail::soa_expand({ (::new(static_cast<void*>(std::get<Is>(m_columns) + n)) typename column_type<Is>::type(std::get<Is>(row)), 0)... });
+    }
+
+    template<class GrowthPolicyT, class... Ts>
+    template<std::size_t... Is>
+    void basic_soa_vector<GrowthPolicyT, Ts...>::move_row(size_type n, value_type& row, detail::soa_indices<Is...>)
+    {
+        detail::soa_expand({ (::new(static_cast<void*>(std::get<Is>(m_columns) + n)) typename column_type<Is>::type(std::move(std::get<Is>(row))), 0)... });
+    }
+
+    template<class GrowthPolicyT, class... Ts>
+    template<std::size_t... Is>
+    void basic_soa_vector<GrowthPolicyT, Ts...>::default_init_rows(size_type first, size_type last, detail::soa_indices<Is...>)
+    {
+        for(size_type n = first; n != last; ++n)
+            detail::soa_expand({ (::new(static_cast<void*>(std::get<Is>(m_columns) + n)) typename column_type<Is>::type(), 0)... });
+    }
+
+    template<class GrowthPolicyT, class... Ts>
+    template<std::size_t... Is>
+    void basic_soa_vector<GrowthPolicyT, Ts...>::destroy_rows(size_type first, size_type last, detail::soa_indices<Is...>)
+    {
+        detail::soa_expand({ (destroy(std::get<Is>(m_columns) + first, std::get<Is>(m_columns) + last,
+                                      std::integral_constant<bool, std::is_trivially_destructible<typename column_type<Is>::type>::value>()), 0)... });
+    }
+
+    template<class GrowthPolicyT, class... Ts>
+    template<std::size_t... Is>
+    void basic_soa_vector<GrowthPolicyT, Ts...>::shift_down(size_type index, detail::soa_indices<Is...>)
+    {
+        detail::soa_expand({ (std::move(std::get<Is>(m_columns) + index + 1, std::get<Is>(m_columns) + m_size, std::get<Is>(m_columns) + index), 0)... });
+    }
+
+    template<class GrowthPolicyT, class... Ts>
+    template<class T>
+    void basic_soa_vector<GrowthPolicyT, Ts...>::destroy(T* first, T* last, std::false_type)
+    {
+        for(; first != last; ++first)
+            first->~T();
+    }
+
+    template<class GrowthPolicyT, class... Ts>
+    void basic_soa_vector<GrowthPolicyT, Ts...>::release()
+    {
+        clear();
+        if(m_block)
+            block_allocator_t().deallocate(m_block, m_block_bytes);
+        m_columns = std::tuple<Ts*...>();
+        m_capacity = 0;
+        m_block = 0;
+        m_block_bytes = 0;
+    }
+}
+namespace std
+{
+    template<class GrowthPolicyT, class... Ts>
+    inline void swap(noe_std::basic_soa_vector<GrowthPolicyT, Ts...>& v1, noe_std::basic_soa_vector<GrowthPolicyT, Ts...>& v2) noe_std_no_except
+    {
+        v1.swap(v2);
+    }
+}
+
+#endif // GUARD_NOE_STD_soa_vector_H
@@ -0,0 +1,472 @@
+/**
+ * NoException Standard Library Container Implementation
+ * by Marvin Manese 2017
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+#ifndef GUARD_NOE_STD_static_vector_H
+#define GUARD_NOE_STD_static_vector_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#if __cplusplus >= 201103L
+#include <initializer_list>
+#endif // __cplusplus >= 201103L
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include "macro.h"
+#include "simd_algorithm.h"
+#include "type_traits.h"
+#include "detail/vector_constructor.h"
+#include "detail/vector_data.h"
+
+namespace noe_std
+{
+namespace detail
+{
+    /// Element count and buffer of a static_vector. For trivially copyable elements every special
+    /// member is left implicit, which keeps the whole static_vector trivially copyable
+    template<class T, std::size_t N, bool TriviallyCopyable = std::is_trivially_copyable<T>::value>
+    struct static_vector_base
+    {
+        static_vector_base() noe_std_no_except : m_size(0) {}
+
+        std::size_t                                 m_size;
+        alignas(T) unsigned char                    m_storage[sizeof(T) * N];
+    };
+
+    /// Other elements are copied, moved and destroyed one by one
+    template<class T, std::size_t N>
+    struct static_vector_base<T, N, false>
+    {
+        static_vector_base() noe_std_no_except : m_size(0) {}
+        static_vector_base(const static_vector_base& rhs) : m_size(0) { copy_data(rhs); }
+        static_vector_base(static_vector_base&& rhs) : m_size(0) { move_data(rhs, std::integral_constant<bool, is_trivially_relocatable<T>::value>()); }
+        ~static_vector_base() { clear_data(); }
+
+        static_vector_base& operator=(const static_vector_base& rhs)
+        {
+            if(this != &rhs) {
+                clear_data();
+                copy_data(rhs);
+            }
+            return *this;
+        }
+
+        static_vector_base& operator=(static_vector_base&& rhs)
+        {
+            if(this != &rhs) {
+                clear_data();
+                move_data(rhs, std::integral_constant<bool, is_trivially_relocatable<T>::value>());
+            }
+            return *this;
+        }
+
+        T* elements() noe_std_no_except { return reinterpret_cast<T*>(m_storage); }
+        const T* elements() const noe_std_no_except { return reinterpret_cast<const T*>(m_storage); }
+
+        void copy_data(const static_vector_base& rhs)
+        {
+            placement_constructor ctor;
+            for(std::size_t i = 0; i < rhs.m_size; ++i) {
+                ctor.construct((elements() + m_size), rhs.elements()[i]); // invoke copy constructor
+                ++m_size; // increment size here for exception safety
+            }
+        }
+
+        void move_data(static_vector_base& rhs, std::true_type)
+        {
+            std::memcpy(static_cast<void*>(m_storage), static_cast<const void*>(rhs.m_storage), rhs.m_size * sizeof(T));
+            m_size = rhs.m_size;
+            rhs.m_size = 0; // objects now live in this, rhs storage must not be destroyed
+        }
+
+        void move_data(static_vector_base& rhs, std::false_type)
+        {
+            placement_constructor ctor;
+            for(std::size_t i = 0; i < rhs.m_size; ++i) {
+                ctor.construct((elements() + m_size), std::move(rhs.elements()[i]));
+                ++m_size;
+            }
+            rhs.clear_data();
+        }
+
+        void clear_data()
+        {
+            // destroy top most
+            while(m_size)
+                elements()[--m_size].~T();
+        }
+
+        std::size_t                                 m_size;
+        alignas(T) unsigned char                    m_storage[sizeof(T) * N];
+    };
+}
+    /// vector with a fixed capacity of N elements stored inside the object.
+    /// Never allocates, insertions that do not fit return false and leave the container untouched.
+    /// Only the element count is stored next to the buffer, and a static_vector of trivially
+    /// copyable elements is trivially copyable itself, so it can be placed in shared memory or
+    /// copied bitwise.
+    template<class T,
+             std::size_t N>
+    class static_vector : private detail::static_vector_base<T, N>
+    {
+        typedef detail::static_vector_base<T, N> base_t;
+
+    public:
+        typedef T                   value_type;
+        typedef std::size_t         size_type;
+        typedef std::ptrdiff_t      difference_type;
+        typedef value_type&         reference;
+        typedef const value_type&   const_reference;
+        typedef value_type*         pointer;
+        typedef const value_type*   const_pointer;
+        typedef pointer             iterator;
+        typedef const_pointer       const_iterator;
+
+        // copy, move and destruction come from the base
+        static_vector() noe_std_no_except {}
+        // elements beyond the capacity are dropped
+        template<class InputIt,
+                 class = typename std::enable_if<!std::is_integral<InputIt>::value>::type>
+        static_vector(InputIt first, InputIt last);
+        explicit static_vector(size_type count, const T& t = T());
+
+        reference operator[](size_type n) { return data()[n]; }
+        const_reference operator[](size_type n) const { return data()[n]; }
+        reference front() { return data()[0]; }
+        const_reference front() const { return data()[0]; }
+        reference back() { return data()[m_size - 1]; }
+        const_reference back() const { return data()[m_size - 1]; }
+        pointer data() noe_std_no_except { return reinterpret_cast<pointer>(m_storage); }
+        const_pointer data() const noe_std_no_except { return reinterpret_cast<const_pointer>(m_storage); }
+
+        iterator begin() noe_std_no_except { return data(); }
+        const_iterator begin() const noe_std_no_except { return data(); }
+        const_iterator cbegin() const noe_std_no_except { return data(); }
+        iterator end() noe_std_no_except { return data() + m_size; }
+        const_iterator end() const noe_std_no_except { return data() + m_size; }
+        const_iterator cend() const noe_std_no_except { return data() + m_size; }
+
+        bool empty() const noe_std_no_except { return (m_size == 0); }
+        bool full() const noe_std_no_except { return (m_size == N); }
+        size_type size() const noe_std_no_except { return m_size; }
+        static constexpr size_type max_size() noe_std_no_except { return N; }
+        static constexpr size_type capacity() noe_std_no_except { return N; }
+        bool reserve(size_type n) const noe_std_no_except { return (n <= N); } // nothing to allocate, only reports if n fits
+
+        void clear();
+        bool insert(iterator pos, const_reference v);
+#if __cplusplus >= 201103L
+        bool insert(iterator pos, value_type&& v);
+#endif // __cplusplus >= 201103L
+        bool insert(iterator pos, size_type count, const_reference v);
+        template<class InputIt,
+                 class = typename std::enable_if<!std::is_integral<InputIt>::value>::type>
+        bool insert(iterator pos, InputIt first, InputIt last);
+#if __cplusplus >= 201103L
+        bool insert(iterator pos, std::initializer_list<T> init_list);
+        template<class... Args> bool emplace(iterator pos, Args&&... args);
+#endif // __cplusplus >= 201103L
+        template<class InputIt> bool append(InputIt first, InputIt last);
+        void erase(iterator it);
+        void erase(iterator first, iterator last);
+        bool push_back(const_reference v);
+#if __cplusplus >= 201103L
+        bool push_back(value_type&& v);
+        template<class... Args> bool emplace_back(Args&&... args);
+#endif // __cplusplus >= 201103L
+        void pop_back();
+        bool resize(size_type n);
+        bool resize(size_type n, const_reference v);
+        void swap(static_vector& other);
+
+    private:
+        template<class U, std::size_t M, class Pred> friend typename static_vector<U, M>::size_type erase_if(static_vector<U, M>& v, Pred pred);
+
+        template<class InputIt> bool insert_range(size_type index, InputIt first, InputIt last, std::input_iterator_tag);
+        template<class ForwardIt> bool insert_range(size_type index, ForwardIt first, ForwardIt last, std::forward_iterator_tag);
+        template<class Constructor> bool insert_n(size_type index, size_type n, Constructor ctor);
+
+        using base_t::m_size;
+        using base_t::m_storage;
+    };
+
+    template<class T, std::size_t N>
+    template<class InputIt, class>
+    static_vector<T, N>::static_vector(InputIt first, InputIt last)
+    {
+        detail::placement_constructor ctor;
+        for(; first != last && m_size < N; ++first) {
+            ctor.construct((data() + m_size), *first);
+            ++m_size; // increment size here for exception safety
+        }
+    }
+
+    template<class T, std::size_t N>
+    static_vector<T, N>::static_vector(size_type count, const T& t)
+    {
+        resize(std::min(count, size_type(N)), t);
+    }
+
+    template<class T, std::size_t N>
+    inline void static_vector<T, N>::clear()
+    {
+        detail::placement_constructor placement;
+        detail::vector_clear_data(placement, data(), m_size);
+        m_size = 0;
+    }
+
+    template<class T, std::size_t N>
+    inline bool static_vector<T, N>::insert(iterator pos, const_reference v)
+    {
+        return insert(pos, 1, v);
+    }
+#if __cplusplus >= 201103L
+    template<class T, std::size_t N>
+    inline bool static_vector<T, N>::insert(iterator pos, value_type&& v)
+    {
+        return emplace(pos, std::move(v));
+    }
+#endif // __cplusplus >= 201103L
+    template<class T, std::size_t N>
+    bool static_vector<T, N>::insert(iterator pos, size_type count, const_reference v)
+    {
+        pointer first = data();
+        if(&v >= first && &v < first + m_size) { // v lives in this vector and would be shifted
+            value_type copy(v);
+            return insert_n(pos - first, count, detail::vector_fill_constructor<value_type>(copy));
+        }
+        return insert_n(pos - first, count, detail::vector_fill_constructor<value_type>(v));
+    }
+
+    template<class T, std::size_t N>
+    template<class InputIt, class>
+    inline bool static_vector<T, N>::insert(iterator pos, InputIt first, InputIt last)
+    {
+        return insert_range(pos - data(), first, last, typename std::iterator_traits<InputIt>::iterator_category());
+    }
+#if __cplusplus >= 201103L
+    template<class T, std::size_t N>
+    inline bool static_vector<T, N>::insert(iterator pos, std::initializer_list<T> init_list)
+    {
+        return insert_n(pos - data(), init_list.size(), detail::vector_range_constructor<const T*>(init_list.begin()));
+    }
+
+    template<class T, std::size_t N>
+    template<class... Args>
+    bool static_vector<T, N>::emplace(iterator pos, Args&&... args)
+    {
+        if(m_size == N)
+            return false;
+        if(pos == end())
+            return emplace_back(std::forward<Args>(args)...);
+        // args may refer to elements that are about to be shifted
+        value_type v(std::forward<Args>(args)...);
+        return insert_n(pos - data(), 1, detail::vector_range_constructor<std::move_iterator<pointer>>(std::move_iterator<pointer>(&v)));
+    }
+#endif // __cplusplus >= 201103L
+    template<class T, std::size_t N>
+    template<class InputIt>
+    inline bool static_vector<T, N>::append(InputIt first, InputIt last)
+    {
+        return insert_range(m_size, first, last, typename std::iterator_traits<InputIt>::iterator_category());
+    }
+
+    template<class T, std::size_t N>
+    inline void static_vector<T, N>::erase(iterator it)
+    {
+        detail::placement_constructor placement;
+        detail::vector_erase_data(placement, data(), m_size, it, it + 1);
+    }
+
+    template<class T, std::size_t N>
+    inline void static_vector<T, N>::erase(iterator first, iterator last)
+    {
+        detail::placement_constructor placement;
+        detail::vector_erase_data(placement, data(), m_size, first, last);
+    }
+
+    template<class T, std::size_t N>
+    bool static_vector<T, N>::push_back(const_reference v)
+    {
+        if(m_size == N)
+            return false;
+        detail::placement_constructor().construct((data() + m_size), v);
+        ++m_size;
+        return true;
+    }
+#if __cplusplus >= 201103L
+    template<class T, std::size_t N>
+    bool static_vector<T, N>::push_back(value_type&& v)
+    {
+        if(m_size == N)
+            return false;
+        detail::placement_constructor().construct((data() + m_size), std::move(v));
+        ++m_size;
+        return true;
+    }
+
+    template<class T, std::size_t N>
+    template<class... Args>
+    bool static_vector<T, N>::emplace_back(Args&&... args)
+    {
+        if(m_size == N)
+            return false;
+        detail::placement_constructor().construct((data() + m_size), std::forward<Args>(args)...);
+        ++m_size; // if exception was thrown before this, size won't change
+        return true;
+    }
+#endif // __cplusplus >= 201103L
+    template<class T, std::size_t N>
+    void static_vector<T, N>::pop_back()
+    {
+        --m_size;
+        data()[m_size].~T();
+    }
+
+    template<class T, std::size_t N>
+    inline bool static_vector<T, N>::resize(size_type n)
+    {
+        return resize(n, T());
+    }
+
+    template<class T, std::size_t N>
+    bool static_vector<T, N>::resize(size_type n, const_reference v)
+    {
+        if(n > N)
+            return false;
+        if(n > m_size) {
+            detail::placement_constructor ctor;
+            while(m_size < n) {
+                ctor.construct((data() + m_size), v);
+                ++m_size;
+            }
+        } else if(n < m_size) {
+            erase(begin() + n, end());
+        }
+        return true;
+    }
+
+    template<class T, std::size_t N>
+    void static_vector<T, N>::swap(static_vector& other)
+    {
+        // buffers are part of the objects, so the elements have to be exchanged
+        static_vector tmp(std::move(other));
+        other = std::move(*this);
+        *this = std::move(tmp);
+    }
+
+    template<class T, std::size_t N>
+    template<class InputIt>
+    bool static_vector<T, N>::insert_range(size_type index, InputIt first, InputIt last, std::input_iterator_tag)
+    {
+        // length is unknown for single pass ranges, so append at the back and rotate into place once
+        size_type old_size = m_size;
+        detail::placement_constructor ctor;
+        for(; first != last; ++first) {
+            if(m_size == N) {
+                detail::vector_clear_data(ctor, data() + old_size, m_size - old_size);
+                m_size = old_size;
+                return false;
+            }
+            ctor.construct((data() + m_size), *first);
+            ++m_size;
+        }
+        std::rotate(data() + index, data() + old_size, data() + m_size);
+        return true;
+    }
+
+    template<class T, std::size_t N>
+    template<class ForwardIt>
+    inline bool static_vector<T, N>::insert_range(size_type index, ForwardIt first, ForwardIt last, std::forward_iterator_tag)
+    {
+        return insert_n(index, static_cast<size_type>(std::distance(first, last)), detail::vector_range_constructor<ForwardIt>(first));
+    }
+
+    template<class T, std::size_t N>
+    template<class Constructor>
+    bool static_vector<T, N>::insert_n(size_type index, size_type n, Constructor ctor)
+    {
+        if(n > N - m_size)
+            return false;
+        detail::placement_constructor placement;
+        if(n > 0)
+            detail::vector_insert_in_place(placement, data(), m_size, index, n, ctor);
+        return true;
+    }
+
+    /// Removes every element satisfying pred in a single pass, returns the number of removed elements
+    template<class T, std::size_t N, class Pred>
+    typename static_vector<T, N>::size_type erase_if(static_vector<T, N>& v, Pred pred)
+    {
+        detail::placement_constructor placement;
+        return detail::vector_erase_if_data(placement, v.data(), v.m_size, pred);
+    }
+
+    template<class T, std::size_t N>
+    bool operator==(const static_vector<T, N>& lhs, const static_vector<T, N>& rhs) noe_std_no_except
+    {
+        return lhs.size() == rhs.size() &&
+               detail::contiguous_equal(lhs.data(), rhs.data(), lhs.size(), std::integral_constant<bool, simd::is_vectorizable<T>::value>());
+    }
+
+    template<class T, std::size_t N>
+    inline bool operator!=(const static_vector<T, N>& lhs, const static_vector<T, N>& rhs) noe_std_no_except
+    {
+        return !(lhs == rhs);
+    }
+
+    template<class T, std::size_t N>
+    inline bool operator<(const static_vector<T, N>& lhs, const static_vector<T, N>& rhs) noe_std_no_except
+    {
+        return detail::contiguous_less(lhs.data(), lhs.size(), rhs.data(), rhs.size(), std::integral_constant<bool, simd::is_vectorizable<T>::value>());
+    }
+
+    template<class T, std::size_t N>
+    inline bool operator<=(const static_vector<T, N>& lhs, const static_vector<T, N>& rhs) noe_std_no_except
+    {
+        return !(rhs < lhs);
+    }
+
+    template<class T, std::size_t N>
+    inline bool operator>(const static_vector<T, N>& lhs, const static_vector<T, N>& rhs) noe_std_no_except
+    {
+        return (rhs < lhs);
+    }
+
+    template<class T, std::size_t N>
+    inline bool operator>=(const static_vector<T, N>& lhs, const static_vector<T, N>& rhs) noe_std_no_except
+    {
+        return !(lhs < rhs);
+    }
+}
+namespace std
+{
+    template<class T, std::size_t N>
+    inline void swap(noe_std::static_vector<T, N>& v1, noe_std::static_vector<T, N>& v2)
+    {
+        v1.swap(v2);
+    }
+}
+
+#endif // GUARD_NOE_STD_static_vector_H
@@ -0,0 +1,320 @@
+/**
+ * NoException Standard Library Container Implementation
+ * by Marvin Manese 2017
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ * of the Software, and to permit persons to whom the Software is furnished to do
+ * so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ **/
+#ifndef GUARD_NOE_STD_thread_pool_H
+#define GUARD_NOE_STD_thread_pool_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <thread>
+#include "macro.h"
+#include "vector.h"
+
+namespace noe_std
+{
+namespace detail
+{
+    struct thread_pool_job;
+
+    /// A range [m_first, m_last) of chunk indices of a job
+    struct thread_pool_task
+    {
+        thread_pool_job*    m_job;
+        std::size_t         m_first;
+        std::size_t         m_last;
+    };
+
+    struct thread_pool_job
+    {
+        void                        (*m_run)(void* context, std::size_t first, std::size_t last);
+        void*                       m_context;
+        std::atomic<std::size_t>    m_remaining;
+    };
+
+    /// Per worker task deque, the owner pushes and pops at the back, thieves take from the front
+    class thread_pool_deque
+    {
+    public:
+        thread_pool_deque() : m_head(0) {}
+
+        bool push(const thread_pool_task& task)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_tasks.push_back(task);
+        }
+
+        bool pop(thread_pool_task& task)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if(m_tasks.size() == m_head)
+                return false;
+            task = m_tasks.back();
+            m_tasks.pop_back();
+            reset_if_drained();
+            return true;
+        }
+
+        bool steal(thread_pool_task& task)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if(m_tasks.size() == m_head)
+                return false;
+            task = m_tasks[m_head++];
+            reset_if_drained();
+            return true;
+        }
+
+    private:
+        void reset_if_drained()
+        {
+            if(m_tasks.size() == m_head) {
+                m_tasks.clear();
+                m_head = 0;
+            }
+        }
+
+        std::mutex                      m_mutex;
+        vector<thread_pool_task>        m_tasks;
+        std::size_t                     m_head;
+    };
+}
+    /// Work stealing thread pool. Every worker owns a deque of tasks, a worker splits its task in
+    /// halves, keeps one and pushes the other for idle workers to steal, so the load balances itself.
+    /// Threads that are not workers (and submit work) share one extra deque and help run tasks
+    /// until their own job is done, so run may be called from inside a task as well.
+    /// Nothing throws: start reports failure, and a pool that is not running executes run inline.
+    class thread_pool
+    {
+    public:
+        thread_pool() noe_std_no_except;
+        ~thread_pool() { stop(); }
+
+        /// Starts workers threads (hardware_concurrency if 0), false if they could not be created
+        bool start(std::size_t workers = 0);
+        /// Waits for the workers to finish their current tasks and joins them
+        void stop();
+        std::size_t size() const noe_std_no_except { return m_worker_count; }
+
+        /// Calls run(context, first, last) on disjoint ranges covering the chunk indices [0, chunks),
+        /// returns once all of them ran
+        void run(std::size_t chunks, void (*run)(void* context, std::size_t first, std::size_t last), void* context);
+
+    private:
+        thread_pool(const thread_pool&);
+        thread_pool& operator=(const thread_pool&);
+
+        struct thread_slot
+        {
+            thread_pool*    m_pool;
+            std::size_t     m_index;
+        };
+
+        static thread_slot& current_slot() noe_std_no_except
+        {
+            static thread_local thread_slot slot = { 0, 0 };
+            return slot;
+        }
+
+        std::size_t own_deque() const noe_std_no_except;
+        bool find_task(std::size_t own, detail::thread_pool_task& task);
+        bool push_task(std::size_t own, const detail::thread_pool_task& task);
+        void execute(std::size_t own, detail::thread_pool_task task);
+        void worker_loop(std::size_t index);
+
+        detail::thread_pool_deque*  m_deques;       // one per worker plus the shared one at m_worker_count
+        std::thread*                m_threads;
+        std::size_t                 m_worker_count;
+        std::atomic<std::size_t>    m_pending;
+        std::atomic<bool>           m_stop;
+        std::mutex                  m_sleep_mutex;
+        std::condition_variable     m_sleep;
+    };
+
+    inline thread_pool::thread_pool() noe_std_no_except
+        : m_deques(0), m_threads(0), m_worker_count(0), m_pending(0), m_stop(false)
+    {
+    }
+
+    inline bool thread_pool::start(std::size_t workers)
+    {
+        if(m_worker_count)
+            return true;
+        if(!workers)
+            workers = std::thread::hardware_concurrency() ? std::thread::hardware_concurrency() : 1;
+
+        m_deques = new(std::nothrow) detail::thread_pool_deque[workers + 1];
+        m_threads = new(std::nothrow) std::thread[workers];
+        if(!m_deques || !m_threads) {
+            delete[] m_deques;
+            delete[] m_threads;
+            m_deques = 0;
+            m_threads = 0;
+            return false;
+        }
+
+        // workers read the count, so it is set before the first one starts
+        m_stop.store(false);
+        m_worker_count = workers;
+        std::size_t started = 0;
+#if defined(__cpp_exceptions) || defined(__EXCEPTIONS) || defined(_CPPUNWIND)
+        try {
+#endif // exceptions enabled
+            for(; started < workers; ++started)
+                m_threads[started] = std::thread(&thread_pool::worker_loop, this, started);
+#if defined(__cpp_exceptions) || defined(__EXCEPTIONS) || defined(_CPPUNWIND)
+        }
+        catch(...) {
+            // std::thread reports a failed creation with std::system_error, turn it into false
+        }
+#endif // exceptions enabled
+        if(started != workers) {
+            stop();
+            return false;
+        }
+        return true;
+    }
+
+    inline void thread_pool::stop()
+    {
+        if(!m_threads)
+            return;
+        {
+            std::lock_guard<std::mutex> lock(m_sleep_mutex);
+            m_stop.store(true);
+        }
+        m_sleep.notify_all();
+        for(std::size_t i = 0; i < m_worker_count; ++i) {
+            if(m_threads[i].joinable())
+                m_threads[i].join();
+        }
+        delete[] m_threads;
+        delete[] m_deques;
+        m_threads = 0;
+        m_deques = 0;
+        m_worker_count = 0;
+        m_pending.store(0);
+    }
+
+    inline void thread_pool::run(std::size_t chunks, void (*run)(void* context, std::size_t first, std::size_t last), void* context)
+    {
+        if(chunks == 0)
+            return;
+        if(!m_worker_count || chunks == 1) {
+            run(context, 0, chunks);
+            return;
+        }
+
+        detail::thread_pool_job job;
+        job.m_run = run;
+        job.m_context = context;
+        job.m_remaining.store(chunks);
+        detail::thread_pool_task root = { &job, 0, chunks };
+        std::size_t own = own_deque();
+        execute(own, root);
+
+        // help with whatever is queued until every chunk of this job ran
+        detail::thread_pool_task task;
+        while(job.m_remaining.load(std::memory_order_acquire)) {
+            if(find_task(own, task))
+                execute(own, task);
+            else
+                std::this_thread::yield();
+        }
+    }
+
+    inline std::size_t thread_pool::own_deque() const noe_std_no_except
+    {
+        const thread_slot& slot = current_slot();
+        return slot.m_pool == this ? slot.m_index : m_worker_count;
+    }
+
+    inline bool thread_pool::find_task(std::size_t own, detail::thread_pool_task& task)
+    {
+        if(m_deques[own].pop(task)) {
+            m_pending.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+        // steal, starting from the next deque so thieves spread out
+        for(std::size_t i = 1; i <= m_worker_count; ++i) {
+            if(m_deques[(own + i) % (m_worker_count + 1)].steal(task)) {
+                m_pending.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    inline bool thread_pool::push_task(std::size_t own, const detail::thread_pool_task& task)
+    {
+        // counted first so a thief never sees the count below the queued tasks
+        m_pending.fetch_add(1, std::memory_order_relaxed);
+        if(!m_deques[own].push(task)) {
+            m_pending.fetch_sub(1, std::memory_order_relaxed);
+            return false;
+        }
+        {
+            // taken so a worker going to sleep can not miss the task
+            std::lock_guard<std::mutex> lock(m_sleep_mutex);
+        }
+        m_sleep.notify_one();
+        return true;
+    }
+
+    inline void thread_pool::execute(std::size_t own, detail::thread_pool_task task)
+    {
+        // keep the first half, offer the second to thieves, a full deque just runs the rest inline
+        while(task.m_last - task.m_first > 1) {
+            std::size_t middle = task.m_first + (task.m_last - task.m_first) / 2;
+            detail::thread_pool_task half = { task.m_job, middle, task.m_last };
+            if(!push_task(own, half))
+                break;
+            task.m_last = middle;
+        }
+        task.m_job->m_run(task.m_job->m_context, task.m_first, task.m_last);
+        task.m_job->m_remaining.fetch_sub(task.m_last - task.m_first, std::memory_order_release);
+    }
+
+    inline void thread_pool::worker_loop(std::size_t index)
+    {
+        thread_slot& slot = current_slot();
+        slot.m_pool = this;
+        slot.m_index = index;
+
+        detail::thread_pool_task task;
+        while(true) {
+            if(find_task(index, task)) {
+                execute(index, task);
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(m_sleep_mutex);
+            while(!m_stop.load() && !m_pending.load(std::memory_order_relaxed))
+                m_sleep.wait(lock);
+            if(m_stop.load())
+                return;
+        }
+    }
+}
+
+#endif // GUARD_NOE_STD_thread_pool_H
@@ -23,6 +23,10 @@
 #ifndef GUARD_NOE_STD_type_traits_H
 #define GUARD_NOE_STD_type_traits_H
 
+#if __cplusplus >= 201103L
+#include <type_traits>
+#endif // __cplusplus >= 201103L
+
 namespace noe_std
 {
 /// C++11 type traits
@@ -72,6 +76,16 @@ namespace noe_std
     {
         enum : bool { value = false };
     };
+
+    /// Opt-in trait for types whose objects can be moved to a new address with a
+    /// plain memcpy / memmove, leaving the source storage without calling its
+    /// destructor. Trivially copyable types qualify by default, other types
+    /// (ie. types holding an owning pointer) can specialize this to true.
+    template<class T>
+    struct is_trivially_relocatable
+    {
+        enum : bool { value = std::is_trivially_copyable<T>::value };
+    };
 #endif // __cplusplus >= 201103L
 
 /// Non-C++11 type traits
@@ -24,15 +24,23 @@
 #define GUARD_NOE_STD_vector_H
 
 #include <algorithm>
+#include <cstddef>
 #include <cstring>
+#if __cplusplus >= 201103L
+#include <initializer_list>
+#endif // __cplusplus >= 201103L
 #include <iterator>
+#include <type_traits>
 #include <utility>
 #include "allocator.h"
+#include "growth_policy.h"
 #include "macro.h"
+#include "simd_algorithm.h"
+#include "type_traits.h"
+#include "detail/vector_constructor.h"
+#include "detail/vector_data.h"
 
 /// TODO:
-/// - Implement insert
-/// - Implement emplace
 /// - More bug checking
 namespace noe_std
 {
@@ -107,12 +115,32 @@ namespace detail
             }
 
             vector_allocator_impl(const allocator_type& alloc) : allocator_type(alloc), m_capacity(0), m_size(0), m_data(0) {}
-            vector_allocator_impl(const allocator_type& alloc, size_type n) : allocator_type(alloc), m_capacity(n), m_size(0), m_data(n > 0 ? allocator_type::allocate(n) : 0) {}
+            vector_allocator_impl(const allocator_type& alloc, size_type n) : allocator_type(alloc), m_capacity(0), m_size(0), m_data(0) { allocate(n); }
 #if __cplusplus >= 201103L
             vector_allocator_impl(allocator_type&& alloc) : allocator_type(std::move(alloc)), m_capacity(0), m_size(0), m_data(0) {}
-            vector_allocator_impl(allocator_type&& alloc, size_type n) : allocator_type(std::move(alloc)), m_capacity(n), m_size(0), m_data(n > 0 ? allocator_type::allocate(n) : 0) {}
+            vector_allocator_impl(allocator_type&& alloc, size_type n) : allocator_type(std::move(alloc)), m_capacity(0), m_size(0), m_data(0) { allocate(n); }
 #endif // __cplusplus >= 201103L
 
+            void allocate(size_type n)
+            {
+                if(n > 0)
+                    allocate(n, typename allocator_extensions<allocator_type>::has_allocate_at_least());
+            }
+
+            void allocate(size_type n, std::true_type)
+            {
+                // keep whatever the allocator rounded up to as extra capacity
+                allocation_result<pointer, size_type> result = allocator_type::allocate_at_least(n);
+                m_data = result.ptr;
+                m_capacity = result.ptr ? result.count : 0;
+            }
+
+            void allocate(size_type n, std::false_type)
+            {
+                m_data = allocator_type::allocate(n);
+                m_capacity = m_data ? n : 0;
+            }
+
             void swap(vector_allocator_impl& other) noe_std_no_except
             {
                 std::swap(m_capacity, other.m_capacity);
@@ -130,77 +158,113 @@ namespace detail
     };
 }
     template<class T,
-             class AllocatorT = allocator<T>>
-    class vector : private detail::vector_allocator_holder<AllocatorT>
+             class AllocatorT = allocator<T>,
+             class GrowthPolicyT = double_growth_policy>
+    class vector : protected detail::vector_allocator_holder<AllocatorT>
     {
     private:
-        struct base_vector_iterator : std::iterator<std::random_access_iterator_tag, T>
+        /// Contiguous iterators: a thin wrapper over a raw pointer with the full random access
+        /// interface, so standard algorithms take their pointer fast paths and loops vectorize
+        class vector_iterator
         {
-            typedef std::iterator<std::random_access_iterator_tag, T> base_iterator;
-        };
-
-        class vector_iterator : base_vector_iterator
-        {
-        private:
-            typedef typename base_vector_iterator::base_iterator base_iterator;
-
         public:
-            typedef typename base_iterator::value_type          value_type;
-            typedef typename base_iterator::difference_type     difference_type;
-            typedef typename base_iterator::pointer             pointer;
-            typedef typename base_iterator::reference           reference;
-            typedef typename base_iterator::iterator_category   iterator_category;
-
-            explicit vector_iterator(pointer ptr = 0) : m_ptr(ptr) {}
-
-            vector_iterator& operator++() { ++m_ptr; return *this; }
-            const vector_iterator operator++(int) { vector_iterator old = *this; ++m_ptr; return old; }
-            vector_iterator& operator--() { --m_ptr; return *this; }
-            const vector_iterator operator--(int) { vector_iterator old = *this; --m_ptr; return old; }
-            vector_iterator& operator+=(int n) { m_ptr += n; return *this; }
-            vector_iterator& operator-=(int n) { m_ptr -= n; return *this; }
-
-            bool operator==(const vector_iterator& rhs) const { return m_ptr == rhs.m_ptr; }
-            bool operator!=(const vector_iterator& rhs) const { return m_ptr != rhs.m_ptr; }
-            value_type& operator*() { return *m_ptr; }
-            value_type* operator->() { return m_ptr; }
+            typedef T                                   value_type;
+            typedef std::ptrdiff_t                      difference_type;
+            typedef T*                                  pointer;
+            typedef T&                                  reference;
+            typedef std::random_access_iterator_tag     iterator_category;
+#if __cplusplus > 201703L
+            typedef std::contiguous_iterator_tag        iterator_concept;
+#endif // __cplusplus > 201703L
+
+            explicit vector_iterator(pointer ptr = 0) noe_std_no_except : m_ptr(ptr) {}
+
+            reference operator*() const noe_std_no_except { return *m_ptr; }
+            pointer operator->() const noe_std_no_except { return m_ptr; }
+            reference operator[](difference_type n) const noe_std_no_except { return m_ptr[n]; }
+
+            vector_iterator& operator++() noe_std_no_except { ++m_ptr; return *this; }
+            vector_iterator operator++(int) noe_std_no_except { vector_iterator old = *this; ++m_ptr; return old; }
+            vector_iterator& operator--() noe_std_no_except { --m_ptr; return *this; }
+            vector_iterator operator--(int) noe_std_no_except { vector_iterator old = *this; --m_ptr; return old; }
+            vector_iterator& operator+=(difference_type n) noe_std_no_except { m_ptr += n; return *this; }
+            vector_iterator& operator-=(difference_type n) noe_std_no_except { m_ptr -= n; return *this; }
+            friend vector_iterator operator+(vector_iterator it, difference_type n) noe_std_no_except { return it += n; }
+            friend vector_iterator operator+(difference_type n, vector_iterator it) noe_std_no_except { return it += n; }
+            friend vector_iterator operator-(vector_iterator it, difference_type n) noe_std_no_except { return it -= n; }
+            friend difference_type operator-(const vector_iterator& lhs, const vector_iterator& rhs) noe_std_no_except { return lhs.m_ptr - rhs.m_ptr; }
+
+            friend bool operator==(const vector_iterator& lhs, const vector_iterator& rhs) noe_std_no_except { return lhs.m_ptr == rhs.m_ptr; }
+            friend bool operator!=(const vector_iterator& lhs, const vector_iterator& rhs) noe_std_no_except { return lhs.m_ptr != rhs.m_ptr; }
+            friend bool operator<(const vector_iterator& lhs, const vector_iterator& rhs) noe_std_no_except { return lhs.m_ptr < rhs.m_ptr; }
+            friend bool operator<=(const vector_iterator& lhs, const vector_iterator& rhs) noe_std_no_except { return lhs.m_ptr <= rhs.m_ptr; }
+            friend bool operator>(const vector_iterator& lhs, const vector_iterator& rhs) noe_std_no_except { return lhs.m_ptr > rhs.m_ptr; }
+            friend bool operator>=(const vector_iterator& lhs, const vector_iterator& rhs) noe_std_no_except { return lhs.m_ptr >= rhs.m_ptr; }
 
         private:
             pointer m_ptr;
         };
 
-        class const_vector_iterator : base_vector_iterator
+        class const_vector_iterator
         {
-        private:
-            typedef typename base_vector_iterator::base_iterator base_iterator;
-
         public:
-            typedef typename base_iterator::value_type          value_type;
-            typedef typename base_iterator::difference_type     difference_type;
-            typedef typename base_iterator::pointer             pointer;
-            typedef typename base_iterator::reference           reference;
-            typedef typename base_iterator::iterator_category   iterator_category;
-
-//            const_vector_iterator() : m_ptr(0) {}
-            explicit const_vector_iterator(pointer ptr = 0) : m_ptr(ptr) {}
-
-            const const_vector_iterator& operator++() const { ++m_ptr; return *this; }
-            const const_vector_iterator operator++(int) const { const_vector_iterator old = *this; ++m_ptr; return old; }
-            const const_vector_iterator& operator--() const { --m_ptr; return *this; }
-            const const_vector_iterator operator--(int) const { const_vector_iterator old = *this; --m_ptr; return old; }
-            const const_vector_iterator& operator+=(int n) const { m_ptr += n; return *this; }
-            const const_vector_iterator& operator-=(int n) const { m_ptr -= n; return *this; }
-
-            bool operator==(const const_vector_iterator& rhs) const { return m_ptr == rhs.m_ptr; }
-            bool operator!=(const const_vector_iterator& rhs) const { return m_ptr != rhs.m_ptr; }
-            const value_type& operator*() const { return *m_ptr; }
-            const value_type* operator->() const { return m_ptr; }
+            typedef T                                   value_type;
+            typedef std::ptrdiff_t                      difference_type;
+            typedef const T*                            pointer;
+            typedef const T&                            reference;
+            typedef std::random_access_iterator_tag     iterator_category;
+#if __cplusplus > 201703L
+            typedef std::contiguous_iterator_tag        iterator_concept;
+#endif // __cplusplus > 201703L
+
+            explicit const_vector_iterator(pointer ptr = 0) noe_std_no_except : m_ptr(ptr) {}
+            // iterator to const_iterator, also lets the comparisons below take mixed operands
+            const_vector_iterator(const vector_iterator& it) noe_std_no_except : m_ptr(it.operator->()) {}
+
+            reference operator*() const noe_std_no_except { return *m_ptr; }
+            pointer operator->() const noe_std_no_except { return m_ptr; }
+            reference operator[](difference_type n) const noe_std_no_except { return m_ptr[n]; }
+
+            const_vector_iterator& operator++() noe_std_no_except { ++m_ptr; return *this; }
+            const_vector_iterator operator++(int) noe_std_no_except { const_vector_iterator old = *this; ++m_ptr; return old; }
+            const_vector_iterator& operator--() noe_std_no_except { --m_ptr; return *this; }
+            const_vector_iterator operator--(int) noe_std_no_except { const_vector_iterator old = *this; --m_ptr; return old; }
+            const_vector_iterator& operator+=(difference_type n) noe_std_no_except { m_ptr += n; return *this; }
+            const_vector_iterator& operator-=(difference_type n) noe_std_no_except { m_ptr -= n; return *this; }
+            friend const_vector_iterator operator+(const_vector_iterator it, difference_type n) noe_std_no_except { return it += n; }
+            friend const_vector_iterator operator+(difference_type n, const_vector_iterator it) noe_std_no_except { return it += n; }
+            friend const_vector_iterator operator-(const_vector_iterator it, difference_type n) noe_std_no_except { return it -= n; }
+            friend difference_type operator-(const const_vector_iterator& lhs, const const_vector_iterator& rhs) noe_std_no_except { return lhs.m_ptr - rhs.m_ptr; }
+
+            friend bool operator==(const const_vector_iterator& lhs, const const_vector_iterator& rhs) noe_std_no_except { return lhs.m_ptr == rhs.m_ptr; }
+            friend bool operator!=(const const_vector_iterator& lhs, const const_vector_iterator& rhs) noe_std_no_except { return lhs.m_ptr != rhs.m_ptr; }
+            friend bool operator<(const const_vector_iterator& lhs, const const_vector_iterator& rhs) noe_std_no_except { return lhs.m_ptr < rhs.m_ptr; }
+            friend bool operator<=(const const_vector_iterator& lhs, const const_vector_iterator& rhs) noe_std_no_except { return lhs.m_ptr <= rhs.m_ptr; }
+            friend bool operator>(const const_vector_iterator& lhs, const const_vector_iterator& rhs) noe_std_no_except { return lhs.m_ptr > rhs.m_ptr; }
+            friend bool operator>=(const const_vector_iterator& lhs, const const_vector_iterator& rhs) noe_std_no_except { return lhs.m_ptr >= rhs.m_ptr; }
 
         private:
-            mutable pointer m_ptr;
+            pointer m_ptr;
         };
 
+    protected:
+        // storage helpers are shared with the containers built on top of vector (ie. small_vector)
         typedef detail::vector_allocator_holder<AllocatorT> base_t;
+        typedef typename base_t::vector_allocator_impl      impl_t;
+
+        // tags used to pick the bulk memcpy / memmove paths over the per element ones
+        typedef std::integral_constant<bool, is_trivially_relocatable<T>::value>        trivially_relocatable_t;
+        typedef std::integral_constant<bool, std::is_trivially_copyable<T>::value>      trivially_copyable_t;
+        typedef std::integral_constant<bool, std::is_trivially_destructible<T>::value>  trivially_destructible_t;
+        typedef std::integral_constant<bool, std::is_trivially_default_constructible<T>::value>
+                                                                                        trivially_default_constructible_t;
+
+        // optional allocator extensions, see detail::allocator_extensions
+        typedef detail::allocator_extensions<AllocatorT>                                allocator_extensions_t;
+        typedef typename allocator_extensions_t::has_try_expand                         has_try_expand_t;
+        typedef typename allocator_extensions_t::has_shrink_in_place                    has_shrink_in_place_t;
+        typedef std::integral_constant<bool, allocator_extensions_t::has_reallocate::value &&
+                                             is_trivially_relocatable<T>::value>         use_reallocate_t;
 
     public:
         typedef typename base_t::allocator_type     allocator_type;
@@ -233,6 +297,8 @@ namespace detail
         const_reference front() const { return this->m_member.m_data[0]; }
         reference back() { return this->m_member.m_data[this->m_member.m_size - 1]; }
         const_reference back() const { return this->m_member.m_data[this->m_member.m_size - 1]; }
+        pointer data() noe_std_no_except { return this->m_member.m_data; }
+        const_pointer data() const noe_std_no_except { return this->m_member.m_data; }
 
         iterator begin() { return iterator(this->m_member.m_data); }
         const_iterator begin() const { return const_iterator(this->m_member.m_data); }
@@ -249,17 +315,23 @@ namespace detail
         void shrink_to_fit();
 
         void clear();
-//        iterator insert(const_iterator pos, const_reference v);
-//#if __cplusplus >= 201103L
-//        iterator insert(const_iterator pos, value_type&& v);
-//#endif // __cplusplus >= 201103L
-//        iterator insert(const_iterator pos, size_type count, const_reference v);
-//        template<class InputIt> iterator insert(const_iterator pos, InputIt first, InputIt last);
-//#if __cplusplus >= 201103L
-//        iterator insert(const_iterator pos, std::initializer_list<T> init_list);
-//        template<class... Args> void emplace(iterator pos, Args&&... args);
-//#endif // __cplusplus >= 201103L
+        // all insertions grow the capacity at most once and shift the tail once,
+        // false is returned (and the vector is left untouched) if allocation fails
+        bool insert(iterator pos, const_reference v);
+#if __cplusplus >= 201103L
+        bool insert(iterator pos, value_type&& v);
+#endif // __cplusplus >= 201103L
+        bool insert(iterator pos, size_type count, const_reference v);
+        template<class InputIt,
+                 class = typename std::enable_if<!std::is_integral<InputIt>::value>::type>
+        bool insert(iterator pos, InputIt first, InputIt last);
+#if __cplusplus >= 201103L
+        bool insert(iterator pos, std::initializer_list<T> init_list);
+        template<class... Args> bool emplace(iterator pos, Args&&... args);
+#endif // __cplusplus >= 201103L
+        template<class InputIt> bool append(InputIt first, InputIt last);
         void erase(iterator it);
+        void erase(iterator first, iterator last);
         bool push_back(const_reference v);
 #if __cplusplus >= 201103L
         bool push_back(value_type&& v);
@@ -269,42 +341,60 @@ namespace detail
         void pop_back();
         void resize(size_type n);
         void resize(size_type n, const_reference v);
+        // like resize, but trivially default constructible elements are left uninitialized
+        bool resize_default_init(size_type n);
+        // makes room for n more elements and returns where they start (0 if allocation fails),
+        // the caller fills (or placement constructs) them and publishes them with commit
+        pointer append_uninitialized(size_type n);
+        void commit(size_type n) noe_std_no_except { this->m_member.m_size += n; }
         void swap(vector& other) noe_std_no_except;
 
-    private:
-        enum : size_type { DEFAULT_NEW_SIZE = 10 };
-
-        template<class U> friend bool operator==(const vector<U>& lhs, const vector<U>& rhs) noe_std_no_except;
-        template<class U> friend bool operator!=(const vector<U>& lhs, const vector<U>& rhs) noe_std_no_except;
-        template<class U> friend bool operator<(const vector<U>& lhs, const vector<U>& rhs) noe_std_no_except;
-        template<class U> friend bool operator<=(const vector<U>& lhs, const vector<U>& rhs) noe_std_no_except;
-        template<class U> friend bool operator>(const vector<U>& lhs, const vector<U>& rhs) noe_std_no_except;
-        template<class U> friend bool operator>=(const vector<U>& lhs, const vector<U>& rhs) noe_std_no_except;
-        template<class U> friend void std::swap(noe_std::vector<U>& v1, noe_std::vector<U>& v2) noe_std_no_except;
+    protected:
+        template<class U, class AllocatorU, class GrowthPolicyU> friend bool operator==(const vector<U, AllocatorU, GrowthPolicyU>& lhs, const vector<U, AllocatorU, GrowthPolicyU>& rhs) noe_std_no_except;
+        template<class U, class AllocatorU, class GrowthPolicyU> friend bool operator!=(const vector<U, AllocatorU, GrowthPolicyU>& lhs, const vector<U, AllocatorU, GrowthPolicyU>& rhs) noe_std_no_except;
+        template<class U, class AllocatorU, class GrowthPolicyU> friend bool operator<(const vector<U, AllocatorU, GrowthPolicyU>& lhs, const vector<U, AllocatorU, GrowthPolicyU>& rhs) noe_std_no_except;
+        template<class U, class AllocatorU, class GrowthPolicyU> friend bool operator<=(const vector<U, AllocatorU, GrowthPolicyU>& lhs, const vector<U, AllocatorU, GrowthPolicyU>& rhs) noe_std_no_except;
+        template<class U, class AllocatorU, class GrowthPolicyU> friend bool operator>(const vector<U, AllocatorU, GrowthPolicyU>& lhs, const vector<U, AllocatorU, GrowthPolicyU>& rhs) noe_std_no_except;
+        template<class U, class AllocatorU, class GrowthPolicyU> friend bool operator>=(const vector<U, AllocatorU, GrowthPolicyU>& lhs, const vector<U, AllocatorU, GrowthPolicyU>& rhs) noe_std_no_except;
+        template<class U, class AllocatorU, class GrowthPolicyU> friend void std::swap(noe_std::vector<U, AllocatorU, GrowthPolicyU>& v1, noe_std::vector<U, AllocatorU, GrowthPolicyU>& v2) noe_std_no_except;
+        template<class U, class AllocatorU, class GrowthPolicyU, class Pred> friend typename vector<U, AllocatorU, GrowthPolicyU>::size_type erase_if(vector<U, AllocatorU, GrowthPolicyU>& v, Pred pred);
 
         bool check_capacity();
         bool grow();
         bool grow(size_type new_capacity);
+        bool grow_in_place(size_type new_capacity);
+        bool try_expand(size_type new_capacity, std::true_type);
+        bool try_expand(size_type new_capacity, std::false_type);
+        bool reallocate(size_type new_capacity, std::true_type);
+        bool reallocate(size_type new_capacity, std::false_type);
+        bool shrink_in_place(size_type new_capacity, std::true_type);
+        bool shrink_in_place(size_type new_capacity, std::false_type);
+        size_type next_capacity(size_type required) const;
+        size_type index_of(iterator pos) const;
+        template<class InputIt> bool insert_range(size_type index, InputIt first, InputIt last, std::input_iterator_tag);
+        template<class ForwardIt> bool insert_range(size_type index, ForwardIt first, ForwardIt last, std::forward_iterator_tag);
+        template<class Constructor> bool insert_n(size_type index, size_type n, Constructor ctor);
+        void relocate_range(pointer first, pointer last, pointer dest, std::true_type);
+        void relocate_range(pointer first, pointer last, pointer dest, std::false_type);
+        void copy_data(const vector& rhs, std::true_type);
+        void copy_data(const vector& rhs, std::false_type);
+        void relocate_data(impl_t& dest, std::true_type);
+        void relocate_data(impl_t& dest, std::false_type);
         void clear_data(pointer data, size_type size);
+        void default_init_data(pointer data, size_type size, std::true_type);
+        void default_init_data(pointer data, size_type size, std::false_type);
     };
 
-    template<class T, class AllocatorT>
-    vector<T, AllocatorT>::vector(const vector& rhs) :
+    template<class T, class AllocatorT, class GrowthPolicyT>
+    vector<T, AllocatorT, GrowthPolicyT>::vector(const vector& rhs) :
         base_t(AllocatorT(), rhs.m_member.m_size)
     {
-//        if(this->m_member.m_data) // allocation success / rhs has data?
-//            std::copy(rhs.m_member.m_data, rhs.m_member.m_data + rhs.m_member.m_size, this->m_member.m_data);
-//        if(rhs.m_member.m_data) { // capacity check already does the check
-            pointer data = this->m_member.m_data;
-            for(const_iterator it = rhs.cbegin(), it_end = rhs.cend(); it != it_end; ++it) {
-                this->allocator().construct((data + this->m_member.m_size), *(it)); // invoke copy constructor
-                ++this->m_member.m_size; // increment size here for exception safety
-            }
-//        }
+        if(this->m_member.m_data) // allocation success / rhs has data?
+            copy_data(rhs, trivially_copyable_t());
     }
 
-    template<class T, class AllocatorT>
-    vector<T, AllocatorT>& vector<T, AllocatorT>::operator=(const vector& rhs)
+    template<class T, class AllocatorT, class GrowthPolicyT>
+    vector<T, AllocatorT, GrowthPolicyT>& vector<T, AllocatorT, GrowthPolicyT>::operator=(const vector& rhs)
     {
         vector other(rhs);
         swap(other);
@@ -318,8 +408,8 @@ namespace detail
 //        this->allocator().deallocate(this->m_member.m_data, this->m_member.m_capacity);
 //    }
 #if __cplusplus >= 201103L
-    template<class T, class AllocatorT>
-    vector<T, AllocatorT>::vector(vector&& rhs) :
+    template<class T, class AllocatorT, class GrowthPolicyT>
+    vector<T, AllocatorT, GrowthPolicyT>::vector(vector&& rhs) :
         base_t(std::move(rhs))
     {
         rhs.m_member.m_capacity = 0;
@@ -327,8 +417,8 @@ namespace detail
         rhs.m_member.m_data = 0; // transfer ownership
     }
 
-    template<class T, class AllocatorT>
-    vector<T, AllocatorT>& vector<T, AllocatorT>::operator=(vector&& rhs)
+    template<class T, class AllocatorT, class GrowthPolicyT>
+    vector<T, AllocatorT, GrowthPolicyT>& vector<T, AllocatorT, GrowthPolicyT>::operator=(vector&& rhs)
     {
 //        if(this != &rhs) {
 //            // clear old
@@ -345,9 +435,9 @@ namespace detail
         return *this;
     }
 #endif // __cplusplus >= 201103L
-    template<class T, class AllocatorT>
+    template<class T, class AllocatorT, class GrowthPolicyT>
     template<class InputIt>
-    vector<T, AllocatorT>::vector(InputIt first, InputIt last, const allocator_type& alloc) :
+    vector<T, AllocatorT, GrowthPolicyT>::vector(InputIt first, InputIt last, const allocator_type& alloc) :
         base_t(alloc, std::distance(first, last))
     {
         if(this->m_member.m_data) { // allocation success / there is data to be copied?
@@ -360,8 +450,8 @@ namespace detail
         }
     }
 
-    template<class T, class AllocatorT>
-    vector<T, AllocatorT>::vector(size_type count, const T& t, const allocator_type& alloc) :
+    template<class T, class AllocatorT, class GrowthPolicyT>
+    vector<T, AllocatorT, GrowthPolicyT>::vector(size_type count, const T& t, const allocator_type& alloc) :
         base_t(alloc, count)
     {
         if(this->m_member.m_data) { // allocation success / count > 0?
@@ -374,64 +464,112 @@ namespace detail
         }
     }
 
-    template<class T, class AllocatorT>
-    void vector<T, AllocatorT>::reserve(size_type n)
+    template<class T, class AllocatorT, class GrowthPolicyT>
+    void vector<T, AllocatorT, GrowthPolicyT>::reserve(size_type n)
     {
         if(n > this->m_member.m_capacity) {
-            grow(n);
+            grow(std::max(n, GrowthPolicyT::fit(n, sizeof(value_type))));
         }
     }
 
-    template<class T, class AllocatorT>
-    void vector<T, AllocatorT>::shrink_to_fit()
+    template<class T, class AllocatorT, class GrowthPolicyT>
+    void vector<T, AllocatorT, GrowthPolicyT>::shrink_to_fit()
     {
-//        size_type size = this->m_member.m_size;
-//        size_type capacity = this->m_member.m_capacity;
+        size_type size = this->m_member.m_size;
+        size_type capacity = this->m_member.m_capacity;
 
-//        if(size < capacity) {
-//            if(size > 0)
-//                grow(size);
-//            else { // size == 0
-//                this->allocator().deallocate(this->m_member.m_data, capacity);
-//                this->m_member.m_capacity = 0;
-//                this->m_member.m_data = 0;
-//            }
-//        }
-        vector<T> temp(*this);
-        swap(temp);
+        if(size < capacity) {
+            if(size > 0) {
+                if(!shrink_in_place(size, has_shrink_in_place_t()))
+                    grow(size); // relocates, so trivially relocatable types are a single memcpy
+            } else { // size == 0
+                impl_t empty(this->allocator());
+                empty.swap(this->m_member); // old buffer is released by empty's destructor
+            }
+        }
     }
 
-    template<class T, class AllocatorT>
-    void vector<T, AllocatorT>::clear()
+    template<class T, class AllocatorT, class GrowthPolicyT>
+    void vector<T, AllocatorT, GrowthPolicyT>::clear()
     {
         clear_data(this->m_member.m_data, this->m_member.m_size);
         this->m_member.m_size = 0;
     }
 
-    template<class T, class AllocatorT>
-    void vector<T, AllocatorT>::erase(iterator it)
-    {
-        // if(primite_type<T>::value)
-        //  move others
-        //  --m_size;
-        // else
-        //  move others
-        //  call type destructor
-        //  --m_size
-
-        pointer pte = &(*it);
-        difference_type diff = (this->m_member.m_data + this->m_member.m_size) - pte;
-        if(diff > 1) {
-            std::copy(pte + 1, pte + diff, pte);
-            this->allocator().destroy(pte + (diff - 1));
-        } else {
-            this->allocator().destroy(pte);
+    template<class T, class AllocatorT, class GrowthPolicyT>
+    inline bool vector<T, AllocatorT, GrowthPolicyT>::insert(iterator pos, const_reference v)
+    {
+        return insert(pos, 1, v);
+    }
+#if __cplusplus >= 201103L
+    template<class T, class AllocatorT, class GrowthPolicyT>
+    inline bool vector<T, AllocatorT, GrowthPolicyT>::insert(iterator pos, value_type&& v)
+    {
+        return emplace(pos, std::move(v));
+    }
+#endif // __cplusplus >= 201103L
+    template<class T, class AllocatorT, class GrowthPolicyT>
+    bool vector<T, AllocatorT, GrowthPolicyT>::insert(iterator pos, size_type count, const_reference v)
+    {
+        pointer data = this->m_member.m_data;
+        if(&v >= data && &v < data + this->m_member.m_size) { // v lives in this vector and would be shifted
+            value_type copy(v);
+            return insert_n(index_of(pos), count, detail::vector_fill_constructor<value_type>(copy));
+        }
+        return insert_n(index_of(pos), count, detail::vector_fill_constructor<value_type>(v));
+    }
+
+    template<class T, class AllocatorT, class GrowthPolicyT>
+    template<class InputIt, class>
+    inline bool vector<T, AllocatorT, GrowthPolicyT>::insert(iterator pos, InputIt first, InputIt last)
+    {
+        return insert_range(index_of(pos), first, last, typename std::iterator_traits<InputIt>::iterator_category());
+    }
+#if __cplusplus >= 201103L
+    template<class T, class AllocatorT, class GrowthPolicyT>
+    inline bool vector<T, AllocatorT, GrowthPolicyT>::insert(iterator pos, std::initializer_list<T> init_list)
+    {
+        return insert_n(index_of(pos), init_list.size(), detail::vector_range_constructor<const T*>(init_list.begin()));
+    }
+
+    template<class T, class AllocatorT, class GrowthPolicyT>
+    template<class... Args>
+    bool vector<T, AllocatorT, GrowthPolicyT>::emplace(iterator pos, Args&&... args)
+    {
+        size_type index = index_of(pos);
+        if(index == this->m_member.m_size && this->m_member.m_size < this->m_member.m_capacity) {
+            this->allocator().construct((this->m_member.m_data + index), std::forward<Args>(args)...);
+            ++this->m_member.m_size;
+            return true;
         }
-        this->m_member.m_size;
+        // args may refer to elements that are about to be shifted or reallocated
+        value_type v(std::forward<Args>(args)...);
+        return insert_n(index, 1, detail::vector_range_constructor<std::move_iterator<pointer>>(std::move_iterator<pointer>(&v)));
+    }
+#endif // __cplusplus >= 201103L
+    template<class T, class AllocatorT, class GrowthPolicyT>
+    template<class InputIt>
+    inline bool vector<T, AllocatorT, GrowthPolicyT>::append(InputIt first, InputIt last)
+    {
+        return insert_range(this->m_member.m_size, first, last, typename std::iterator_traits<InputIt>::iterator_category());
+    }
+
+    template<class T, class AllocatorT, class GrowthPolicyT>
+    void vector<T, AllocatorT, GrowthPolicyT>::erase(iterator it)
+    {
+        pointer pos = &(*it);
+        detail::vector_erase_data(this->allocator(), this->m_member.m_data, this->m_member.m_size, pos, pos + 1);
+    }
+
+    template<class T, class AllocatorT, class GrowthPolicyT>
+    void vector<T, AllocatorT, GrowthPolicyT>::erase(iterator first, iterator last)
+    {
+        pointer data = this->m_member.m_data;
+        detail::vector_erase_data(this->allocator(), data, this->m_member.m_size, data + index_of(first), data + index_of(last));
     }
 
-    template<class T, class AllocatorT>
-    bool vector<T, AllocatorT>::push_back(const_reference v)
+    template<class T, class AllocatorT, class GrowthPolicyT>
+    bool vector<T, AllocatorT, GrowthPolicyT>::push_back(const_reference v)
     {
         if(!check_capacity())
             return false;
@@ -441,8 +579,8 @@ namespace detail
         return true;
     }
 #if __cplusplus >= 201103L
-    template<class T, class AllocatorT>
-    bool vector<T, AllocatorT>::push_back(value_type&& v)
+    template<class T, class AllocatorT, class GrowthPolicyT>
+    bool vector<T, AllocatorT, GrowthPolicyT>::push_back(value_type&& v)
     {
         if(!check_capacity())
             return false;
@@ -452,9 +590,9 @@ namespace detail
         return true;
     }
 
-    template<class T, class AllocatorT>
+    template<class T, class AllocatorT, class GrowthPolicyT>
     template<class... Args>
-    bool vector<T, AllocatorT>::emplace_back(Args&&... args)
+    bool vector<T, AllocatorT, GrowthPolicyT>::emplace_back(Args&&... args)
     {
         if(!check_capacity())
             return false;
@@ -466,9 +604,9 @@ namespace detail
         return false;
     }
 
-    template<class T, class AllocatorT>
+    template<class T, class AllocatorT, class GrowthPolicyT>
     template<class... Args>
-    std::pair<bool, typename vector<T, AllocatorT>::iterator> vector<T, AllocatorT>::emplace_back(Args&&... args)
+    std::pair<bool, typename vector<T, AllocatorT, GrowthPolicyT>::iterator> vector<T, AllocatorT, GrowthPolicyT>::emplace_back(Args&&... args)
     {
         if(!check_capacity())
             return std::make_pair(false, iterator(0));
@@ -478,22 +616,22 @@ namespace detail
         return std::make_pair(true, iterator(pos));
     }
 #endif // __cplusplus >= 201103L
-    template<class T, class AllocatorT>
-    void vector<T, AllocatorT>::pop_back()
+    template<class T, class AllocatorT, class GrowthPolicyT>
+    void vector<T, AllocatorT, GrowthPolicyT>::pop_back()
     {
         // destructor should not throw exception
         // so exception safe
         this->allocator().destroy(this->m_member.m_data + (--this->m_member.m_size));
     }
 
-    template<class T, class AllocatorT>
-    inline void vector<T, AllocatorT>::resize(size_type n)
+    template<class T, class AllocatorT, class GrowthPolicyT>
+    inline void vector<T, AllocatorT, GrowthPolicyT>::resize(size_type n)
     {
         resize(n, T());
     }
 
-    template<class T, class AllocatorT>
-    void vector<T, AllocatorT>::resize(size_type n, const_reference value)
+    template<class T, class AllocatorT, class GrowthPolicyT>
+    void vector<T, AllocatorT, GrowthPolicyT>::resize(size_type n, const_reference value)
     {
 //        size_type capacity = this->m_member.m_capacity;
 //        size_type size = this->m_member.m_size;
@@ -516,7 +654,7 @@ namespace detail
 
         if(n > size) {
             if(n > capacity) {
-                if(!grow(n))
+                if(!grow(next_capacity(n)))
                     return;
             }
             size_type diff = n - size;
@@ -525,56 +663,68 @@ namespace detail
                 ++this->m_member.m_size;
             }
         } else if(n < size) {
-            size_type diff = size - n;
-            while(diff--) {
-                this->allocator().destroy((this->m_member.m_data + this->m_member.m_size));
-                --this->m_member.m_size;
-            }
+            clear_data(this->m_member.m_data + n, size - n);
+            this->m_member.m_size = n;
         }
     }
 
-    template<class T, class AllocatorT>
-    void vector<T, AllocatorT>::swap(vector& other) noe_std_no_except
+    template<class T, class AllocatorT, class GrowthPolicyT>
+    bool vector<T, AllocatorT, GrowthPolicyT>::resize_default_init(size_type n)
+    {
+        size_type size = this->m_member.m_size;
+        if(n > size) {
+            pointer data = append_uninitialized(n - size);
+            if(!data)
+                return false;
+            default_init_data(data, n - size, trivially_default_constructible_t());
+        } else if(n < size) {
+            clear_data(this->m_member.m_data + n, size - n);
+            this->m_member.m_size = n;
+        }
+        return true;
+    }
+
+    template<class T, class AllocatorT, class GrowthPolicyT>
+    typename vector<T, AllocatorT, GrowthPolicyT>::pointer vector<T, AllocatorT, GrowthPolicyT>::append_uninitialized(size_type n)
+    {
+        size_type required = this->m_member.m_size + n;
+        if(required > this->m_member.m_capacity && !grow(next_capacity(required)))
+            return 0;
+        return this->m_member.m_data + this->m_member.m_size;
+    }
+
+    template<class T, class AllocatorT, class GrowthPolicyT>
+    void vector<T, AllocatorT, GrowthPolicyT>::swap(vector& other) noe_std_no_except
     {
         this->m_member.swap(other.m_member);
     }
 
-    template<class T, class AllocatorT>
-    inline bool vector<T, AllocatorT>::check_capacity()
+    template<class T, class AllocatorT, class GrowthPolicyT>
+    inline bool vector<T, AllocatorT, GrowthPolicyT>::check_capacity()
     {
         if(this->m_member.m_size >= this->m_member.m_capacity)
             return grow();
         return true;
     }
 
-    template<class T, class AllocatorT>
-    inline bool vector<T, AllocatorT>::grow()
+    template<class T, class AllocatorT, class GrowthPolicyT>
+    inline bool vector<T, AllocatorT, GrowthPolicyT>::grow()
     {
-        const size_type default_new_size = DEFAULT_NEW_SIZE;
-        size_type new_capacity = std::max(this->m_member.m_capacity * 2, default_new_size);
-        return grow(new_capacity);
+        return grow(next_capacity(this->m_member.m_size + 1));
     }
 
-    template<class T, class AllocatorT>
-    bool vector<T, AllocatorT>::grow(size_type new_capacity)
+    template<class T, class AllocatorT, class GrowthPolicyT>
+    bool vector<T, AllocatorT, GrowthPolicyT>::grow(size_type new_capacity)
     {
-        size_type size = this->m_member.m_size;
-        pointer old_data = this->m_member.m_data;
+        if(grow_in_place(new_capacity))
+            return true;
 
-        typename detail::vector_allocator_holder<AllocatorT>::vector_allocator_impl tmp(this->allocator(), new_capacity);
+        impl_t tmp(this->allocator(), new_capacity);
         if(!tmp.m_data)
             return false;
 
-        if(size > 0) {
-//            for(size_type i = 0; i < size; ++i) {
-            while(tmp.m_size < size) {
-                size_type tmp_size = tmp.m_size;
-                this->allocator().construct((tmp.m_data + tmp_size), *(old_data + tmp_size));
-                ++tmp.m_size;
-            }
-//            }
-        }
-        tmp.swap(this->m_member);
+        relocate_data(tmp, trivially_relocatable_t());
+        tmp.swap(this->m_member); // tmp now owns the old buffer and releases it
         return true;
 
 //        size_type size = this->m_member.m_size;
@@ -593,72 +743,262 @@ namespace detail
 //        return true;
     }
 
-    template<class T, class AllocatorT>
-    void vector<T, AllocatorT>::clear_data(pointer data, size_type size)
+    template<class T, class AllocatorT, class GrowthPolicyT>
+    bool vector<T, AllocatorT, GrowthPolicyT>::grow_in_place(size_type new_capacity)
+    {
+        // resize the current block without relocating the elements one by one
+        if(!this->m_member.m_data)
+            return false;
+        if(new_capacity > this->m_member.m_capacity && try_expand(new_capacity, has_try_expand_t()))
+            return true;
+        return reallocate(new_capacity, use_reallocate_t());
+    }
+
+    template<class T, class AllocatorT, class GrowthPolicyT>
+    bool vector<T, AllocatorT, GrowthPolicyT>::try_expand(size_type new_capacity, std::true_type)
     {
-        if(size == 0)
-            return;
+        if(!this->allocator().try_expand(this->m_member.m_data, this->m_member.m_capacity, new_capacity))
+            return false;
+        this->m_member.m_capacity = new_capacity;
+        return true;
+    }
 
-        // if(primite_type<T>::value)
-        //  return;
-        // else
-        //  call type destructors
-//        for(size_type i = 0; i < size - 1; ++i)
-//            this->allocator().destroy(data + i);
+    template<class T, class AllocatorT, class GrowthPolicyT>
+    inline bool vector<T, AllocatorT, GrowthPolicyT>::try_expand(size_type, std::false_type)
+    {
+        return false;
+    }
+
+    template<class T, class AllocatorT, class GrowthPolicyT>
+    bool vector<T, AllocatorT, GrowthPolicyT>::reallocate(size_type new_capacity, std::true_type)
+    {
+        // elements are trivially relocatable, so the allocator may move their bytes (ie. realloc / mremap)
+        pointer data = this->allocator().reallocate(this->m_member.m_data, this->m_member.m_capacity, new_capacity);
+        if(!data)
+            return false;
+        this->m_member.m_data = data;
+        this->m_member.m_capacity = new_capacity;
+        return true;
+    }
 
-        // destroy top most
-        while(size)
-            this->allocator().destroy(data + (--size));
+    template<class T, class AllocatorT, class GrowthPolicyT>
+    inline bool vector<T, AllocatorT, GrowthPolicyT>::reallocate(size_type, std::false_type)
+    {
+        return false;
     }
 
-    template<class T>
-    bool operator==(const vector<T>& lhs, const vector<T>& rhs) noe_std_no_except
+    template<class T, class AllocatorT, class GrowthPolicyT>
+    bool vector<T, AllocatorT, GrowthPolicyT>::shrink_in_place(size_type new_capacity, std::true_type)
     {
-        if(lhs.size() != rhs.size())
+        if(!this->allocator().shrink_in_place(this->m_member.m_data, this->m_member.m_capacity, new_capacity))
             return false;
+        this->m_member.m_capacity = new_capacity;
+        return true;
+    }
+
+    template<class T, class AllocatorT, class GrowthPolicyT>
+    inline bool vector<T, AllocatorT, GrowthPolicyT>::shrink_in_place(size_type, std::false_type)
+    {
+        return false;
+    }
 
-        typedef typename vector<T>::const_iterator const_iterator;
-        for(const_iterator it = lhs.cbegin(), it_end = lhs.cend(), it2 = rhs.cbegin(); it != it_end; ++it, ++it2) { // it != it_end should be enough, since we checked if sizes don't match
-            if((*it) != (*it2))
+    template<class T, class AllocatorT, class GrowthPolicyT>
+    inline typename vector<T, AllocatorT, GrowthPolicyT>::size_type vector<T, AllocatorT, GrowthPolicyT>::next_capacity(size_type required) const
+    {
+        size_type new_capacity = GrowthPolicyT::grow(this->m_member.m_capacity, required, sizeof(value_type));
+        return std::max(required, std::min(new_capacity, max_size()));
+    }
+
+    template<class T, class AllocatorT, class GrowthPolicyT>
+    inline typename vector<T, AllocatorT, GrowthPolicyT>::size_type vector<T, AllocatorT, GrowthPolicyT>::index_of(iterator pos) const
+    {
+        return static_cast<size_type>(pos - iterator(this->m_member.m_data));
+    }
+
+    template<class T, class AllocatorT, class GrowthPolicyT>
+    template<class InputIt>
+    bool vector<T, AllocatorT, GrowthPolicyT>::insert_range(size_type index, InputIt first, InputIt last, std::input_iterator_tag)
+    {
+        // length is unknown for single pass ranges, so append at the back and rotate into place once
+        size_type old_size = this->m_member.m_size;
+        for(; first != last; ++first) {
+            if(!check_capacity()) {
+                clear_data(this->m_member.m_data + old_size, this->m_member.m_size - old_size);
+                this->m_member.m_size = old_size;
                 return false;
+            }
+            this->allocator().construct((this->m_member.m_data + this->m_member.m_size), *first);
+            ++this->m_member.m_size;
         }
+        pointer data = this->m_member.m_data;
+        std::rotate(data + index, data + old_size, data + this->m_member.m_size);
+        return true;
+    }
+
+    template<class T, class AllocatorT, class GrowthPolicyT>
+    template<class ForwardIt>
+    inline bool vector<T, AllocatorT, GrowthPolicyT>::insert_range(size_type index, ForwardIt first, ForwardIt last, std::forward_iterator_tag)
+    {
+        return insert_n(index, static_cast<size_type>(std::distance(first, last)), detail::vector_range_constructor<ForwardIt>(first));
+    }
+
+    template<class T, class AllocatorT, class GrowthPolicyT>
+    template<class Constructor>
+    bool vector<T, AllocatorT, GrowthPolicyT>::insert_n(size_type index, size_type n, Constructor ctor)
+    {
+        if(n == 0)
+            return true;
+
+        size_type size = this->m_member.m_size;
+        if(size + n <= this->m_member.m_capacity || grow_in_place(next_capacity(size + n))) {
+            detail::vector_insert_in_place(this->allocator(), this->m_member.m_data, this->m_member.m_size, index, n, ctor);
+            return true;
+        }
+
+        impl_t tmp(this->allocator(), next_capacity(size + n));
+        if(!tmp.m_data)
+            return false;
+
+        // construct the new elements first, they may still read from the old buffer
+        for(size_type i = 0; i < n; ++i)
+            ctor(this->allocator(), tmp.m_data + index + i);
+
+        pointer data = this->m_member.m_data;
+        relocate_range(data, data + index, tmp.m_data, trivially_relocatable_t());
+        relocate_range(data + index, data + size, tmp.m_data + index + n, trivially_relocatable_t());
+        tmp.m_size = size + n;
+        if(trivially_relocatable_t::value)
+            this->m_member.m_size = 0; // objects now live in tmp, old storage must not be destroyed
+        tmp.swap(this->m_member); // tmp now owns the old buffer and releases it
         return true;
     }
 
-    template<class T>
-    inline bool operator!=(const vector<T>& lhs, const vector<T>& rhs) noe_std_no_except
+    template<class T, class AllocatorT, class GrowthPolicyT>
+    void vector<T, AllocatorT, GrowthPolicyT>::relocate_range(pointer first, pointer last, pointer dest, std::true_type)
+    {
+        if(first != last)
+            std::memcpy(static_cast<void*>(dest), static_cast<const void*>(first), (last - first) * sizeof(value_type));
+    }
+
+    template<class T, class AllocatorT, class GrowthPolicyT>
+    void vector<T, AllocatorT, GrowthPolicyT>::relocate_range(pointer first, pointer last, pointer dest, std::false_type)
+    {
+        // sources are destroyed together with the old buffer
+        for(; first != last; ++first, ++dest)
+            this->allocator().construct(dest, std::move_if_noexcept(*first));
+    }
+
+    template<class T, class AllocatorT, class GrowthPolicyT>
+    void vector<T, AllocatorT, GrowthPolicyT>::copy_data(const vector& rhs, std::true_type)
+    {
+        size_type size = rhs.m_member.m_size;
+        std::memcpy(static_cast<void*>(this->m_member.m_data), static_cast<const void*>(rhs.m_member.m_data), size * sizeof(value_type));
+        this->m_member.m_size = size;
+    }
+
+    template<class T, class AllocatorT, class GrowthPolicyT>
+    void vector<T, AllocatorT, GrowthPolicyT>::copy_data(const vector& rhs, std::false_type)
+    {
+        pointer data = this->m_member.m_data;
+        for(const_iterator it = rhs.cbegin(), it_end = rhs.cend(); it != it_end; ++it) {
+            this->allocator().construct((data + this->m_member.m_size), *(it)); // invoke copy constructor
+            ++this->m_member.m_size; // increment size here for exception safety
+        }
+    }
+
+    template<class T, class AllocatorT, class GrowthPolicyT>
+    void vector<T, AllocatorT, GrowthPolicyT>::relocate_data(impl_t& dest, std::true_type)
+    {
+        size_type size = this->m_member.m_size;
+        if(size > 0)
+            std::memcpy(static_cast<void*>(dest.m_data), static_cast<const void*>(this->m_member.m_data), size * sizeof(value_type));
+        dest.m_size = size;
+        this->m_member.m_size = 0; // objects now live in dest, old storage must not be destroyed
+    }
+
+    template<class T, class AllocatorT, class GrowthPolicyT>
+    void vector<T, AllocatorT, GrowthPolicyT>::relocate_data(impl_t& dest, std::false_type)
+    {
+        size_type size = this->m_member.m_size;
+        pointer old_data = this->m_member.m_data;
+        while(dest.m_size < size) {
+            size_type dest_size = dest.m_size;
+            this->allocator().construct((dest.m_data + dest_size), std::move_if_noexcept(*(old_data + dest_size)));
+            ++dest.m_size;
+        }
+    }
+
+    template<class T, class AllocatorT, class GrowthPolicyT>
+    inline void vector<T, AllocatorT, GrowthPolicyT>::clear_data(pointer data, size_type size)
+    {
+        detail::vector_clear_data(this->allocator(), data, size);
+    }
+
+    template<class T, class AllocatorT, class GrowthPolicyT>
+    inline void vector<T, AllocatorT, GrowthPolicyT>::default_init_data(pointer, size_type size, std::true_type)
+    {
+        // nothing to construct, storage keeps whatever it held
+        this->m_member.m_size += size;
+    }
+
+    template<class T, class AllocatorT, class GrowthPolicyT>
+    void vector<T, AllocatorT, GrowthPolicyT>::default_init_data(pointer data, size_type size, std::false_type)
+    {
+        for(size_type i = 0; i < size; ++i) {
+            this->allocator().construct(data + i);
+            ++this->m_member.m_size; // increment size here for exception safety
+        }
+    }
+
+    /// Removes every element satisfying pred in a single pass, returns the number of removed elements
+    template<class T, class AllocatorT, class GrowthPolicyT, class Pred>
+    typename vector<T, AllocatorT, GrowthPolicyT>::size_type erase_if(vector<T, AllocatorT, GrowthPolicyT>& v, Pred pred)
+    {
+        return detail::vector_erase_if_data(v.allocator(), v.m_member.m_data, v.m_member.m_size, pred);
+    }
+
+    template<class T, class AllocatorT, class GrowthPolicyT>
+    bool operator==(const vector<T, AllocatorT, GrowthPolicyT>& lhs, const vector<T, AllocatorT, GrowthPolicyT>& rhs) noe_std_no_except
+    {
+        if(lhs.size() != rhs.size())
+            return false;
+        return detail::contiguous_equal(lhs.data(), rhs.data(), lhs.size(), std::integral_constant<bool, simd::is_vectorizable<T>::value>());
+    }
+
+    template<class T, class AllocatorT, class GrowthPolicyT>
+    inline bool operator!=(const vector<T, AllocatorT, GrowthPolicyT>& lhs, const vector<T, AllocatorT, GrowthPolicyT>& rhs) noe_std_no_except
     {
         return !(lhs == rhs);
     }
 
-    template<class T>
-    inline bool operator<(const vector<T>& lhs, const vector<T>& rhs) noe_std_no_except
+    template<class T, class AllocatorT, class GrowthPolicyT>
+    inline bool operator<(const vector<T, AllocatorT, GrowthPolicyT>& lhs, const vector<T, AllocatorT, GrowthPolicyT>& rhs) noe_std_no_except
     {
-        return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), std::less<T>());
+        return detail::contiguous_less(lhs.data(), lhs.size(), rhs.data(), rhs.size(), std::integral_constant<bool, simd::is_vectorizable<T>::value>());
     }
 
-    template<class T>
-    inline bool operator<=(const vector<T>& lhs, const vector<T>& rhs) noe_std_no_except
+    template<class T, class AllocatorT, class GrowthPolicyT>
+    inline bool operator<=(const vector<T, AllocatorT, GrowthPolicyT>& lhs, const vector<T, AllocatorT, GrowthPolicyT>& rhs) noe_std_no_except
     {
-        return (lhs < rhs || lhs == rhs);
+        return detail::contiguous_less_equal(lhs.data(), lhs.size(), rhs.data(), rhs.size(), std::integral_constant<bool, simd::is_vectorizable<T>::value>());
     }
 
-    template<class T>
-    inline bool operator>(const vector<T>& lhs, const vector<T>& rhs) noe_std_no_except
+    template<class T, class AllocatorT, class GrowthPolicyT>
+    inline bool operator>(const vector<T, AllocatorT, GrowthPolicyT>& lhs, const vector<T, AllocatorT, GrowthPolicyT>& rhs) noe_std_no_except
     {
-        return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), std::greater<T>());
+        return rhs < lhs;
     }
 
-    template<class T>
-    inline bool operator>=(const vector<T>& lhs, const vector<T>& rhs) noe_std_no_except
+    template<class T, class AllocatorT, class GrowthPolicyT>
+    inline bool operator>=(const vector<T, AllocatorT, GrowthPolicyT>& lhs, const vector<T, AllocatorT, GrowthPolicyT>& rhs) noe_std_no_except
     {
-        return (lhs > rhs || lhs == rhs);
+        return rhs <= lhs;
     }
 }
 namespace std
 {
-    template<class T>
-    inline void swap(noe_std::vector<T>& v1, noe_std::vector<T>& v2) noe_std_no_except
+    template<class T, class AllocatorT, class GrowthPolicyT>
+    inline void swap(noe_std::vector<T, AllocatorT, GrowthPolicyT>& v1, noe_std::vector<T, AllocatorT, GrowthPolicyT>& v2) noe_std_no_except
     {
         v1.swap(v2);
     }